@@ -0,0 +1,206 @@
+// Evaluates the uniform samples u = (k + 1) * deltaU of a cinpact curve and writes the valid ones to a vertex buffer.
+// Runs as three dispatches of the same pipeline, pass selects which one:
+// 0: Evaluates one sample per thread and counts the valid samples of each group
+// 1: A single group turns the counts into offsets and writes the vertex count of the indirect draw
+// 2: Each group compacts its valid samples to its offset, so the vertices keep the order of u
+
+#define GROUP_SIZE 256
+#define PASS_EVALUATE 0
+#define PASS_SCAN 1
+#define PASS_COMPACT 2
+
+static const float PI = 3.14159265358979323846;
+static const float FLT_EPSILON = 1.192092896e-07;
+
+struct PushConsts
+{
+    uint pass;
+    uint controlPointCount;
+    uint sampleCount;
+    uint interpolate;
+    float deltaU;
+    float maxC;                 // Largest c, control points further away than this can not reach a sample
+    uint groupCountX;           // Large dispatches are split into rows of this many groups
+};
+
+[[vk::push_constant]]
+cbuffer {
+    PushConsts pushConsts;
+};
+
+[[vk::binding(0, 0)]]
+StructuredBuffer<float> positions;              // 3 floats per control point
+[[vk::binding(1, 0)]]
+StructuredBuffer<float> cConstants;
+[[vk::binding(2, 0)]]
+StructuredBuffer<float> kConstants;
+[[vk::binding(3, 0)]]
+RWStructuredBuffer<float4> samples;             // Indexed by k, w is 1 for valid samples
+[[vk::binding(4, 0)]]
+RWStructuredBuffer<uint> groupOffsets;          // Valid count of each group, turned into offsets by the scan pass
+[[vk::binding(5, 0)]]
+RWStructuredBuffer<float> vertices;             // LinePipeline vertices, 3 floats each
+[[vk::binding(6, 0)]]
+RWStructuredBuffer<uint> drawArguments;         // VkDrawIndirectCommand
+
+groupshared uint scanScratch[GROUP_SIZE];
+
+// Same as Cinpact::CalcA except at the edge of the support
+float CalcA(float u, float i, float c, float k)
+{
+    if (u < -c + i || u > c + i)
+    {
+        return 0.0;
+    }
+
+    float uMinI = u - i;
+    float uMinISquare = uMinI * uMinI;
+
+    float bottom = (c * c) - uMinISquare;
+    // Rounding can leave uMinI just outside of the support, the weight tends to zero there instead of overflowing
+    if (bottom < 0.0)
+    {
+        return 0.0;
+    }
+    if (bottom == 0.0)
+    {
+        bottom += FLT_EPSILON;
+    }
+
+    float top = -k * uMinISquare;
+    return exp(top / bottom);
+}
+
+// Same as Cinpact::CalcI
+float CalcI(float u, float i)
+{
+    float uMinI = u - i;
+    if (uMinI == 0.0)
+    {
+        return 1.0;
+    }
+    return sin(PI * uMinI) / (uMinI * PI);
+}
+
+// Inclusive prefix sum of value over the group, every thread of the group has to call it
+uint GroupInclusiveScan(uint value, uint localIdx)
+{
+    scanScratch[localIdx] = value;
+    GroupMemoryBarrierWithGroupSync();
+    for (uint offset = 1; offset < GROUP_SIZE; offset <<= 1)
+    {
+        uint addend = localIdx >= offset ? scanScratch[localIdx - offset] : 0;
+        GroupMemoryBarrierWithGroupSync();
+        scanScratch[localIdx] += addend;
+        GroupMemoryBarrierWithGroupSync();
+    }
+    return scanScratch[localIdx];
+}
+
+void Evaluate(uint groupIdx, uint localIdx, uint k)
+{
+    float4 sample = float4(0.0, 0.0, 0.0, 0.0);
+    if (k < pushConsts.sampleCount)
+    {
+        float u = (float(k) * pushConsts.deltaU) + pushConsts.deltaU;
+
+        float lastIdx = float(pushConsts.controlPointCount - 1);
+        int first = int(ceil(clamp(u - pushConsts.maxC, 0.0, lastIdx)));
+        int last = int(floor(clamp(u + pushConsts.maxC, 0.0, lastIdx)));
+
+        float3 value = float3(0.0, 0.0, 0.0);
+        float weightSum = 0.0;
+        for (int i = first; i <= last; ++i)
+        {
+            float weight = CalcA(u, float(i), cConstants[i], kConstants[i]);
+            if (pushConsts.interpolate != 0)
+            {
+                weight *= CalcI(u, float(i));
+            }
+            float3 position = float3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            value += weight * position;
+            weightSum += weight;
+        }
+
+        sample.xyz = weightSum != 0.0 ? value / weightSum : value;
+        sample.w = weightSum > 0.0 ? 1.0 : 0.0;
+        samples[k] = sample;
+    }
+
+    GroupInclusiveScan(sample.w > 0.5 ? 1 : 0, localIdx);
+    if (localIdx == GROUP_SIZE - 1)
+    {
+        groupOffsets[groupIdx] = scanScratch[GROUP_SIZE - 1];
+    }
+}
+
+void Scan(uint localIdx)
+{
+    uint groupCount = (pushConsts.sampleCount + GROUP_SIZE - 1) / GROUP_SIZE;
+    uint runningTotal = 0;
+    for (uint chunk = 0; chunk < groupCount; chunk += GROUP_SIZE)
+    {
+        uint idx = chunk + localIdx;
+        uint count = idx < groupCount ? groupOffsets[idx] : 0;
+        uint inclusive = GroupInclusiveScan(count, localIdx);
+        if (idx < groupCount)
+        {
+            groupOffsets[idx] = runningTotal + inclusive - count;
+        }
+        runningTotal += scanScratch[GROUP_SIZE - 1];
+        // The next chunk overwrites the scratch that was just read
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (localIdx == 0)
+    {
+        drawArguments[0] = runningTotal;        // vertexCount
+        drawArguments[1] = 1;                   // instanceCount
+        drawArguments[2] = 0;                   // firstVertex
+        drawArguments[3] = 0;                   // firstInstance
+    }
+}
+
+void Compact(uint groupIdx, uint localIdx, uint k)
+{
+    float4 sample = k < pushConsts.sampleCount ? samples[k] : float4(0.0, 0.0, 0.0, 0.0);
+    uint isValid = sample.w > 0.5 ? 1 : 0;
+    uint inclusive = GroupInclusiveScan(isValid, localIdx);
+    if (isValid == 1)
+    {
+        uint vertexIdx = groupOffsets[groupIdx] + inclusive - 1;
+        vertices[vertexIdx * 3] = sample.x;
+        vertices[vertexIdx * 3 + 1] = sample.y;
+        vertices[vertexIdx * 3 + 2] = sample.z;
+    }
+}
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID)
+{
+    uint localIdx = groupThreadId.x;
+
+    if (pushConsts.pass == PASS_SCAN)
+    {
+        Scan(localIdx);
+        return;
+    }
+
+    uint groupIdx = groupId.y * pushConsts.groupCountX + groupId.x;
+    uint groupCount = (pushConsts.sampleCount + GROUP_SIZE - 1) / GROUP_SIZE;
+    // The whole group leaves together, so the group barriers below stay uniform
+    if (groupIdx >= groupCount)
+    {
+        return;
+    }
+
+    uint k = groupIdx * GROUP_SIZE + localIdx;
+    if (pushConsts.pass == PASS_EVALUATE)
+    {
+        Evaluate(groupIdx, localIdx, k);
+    }
+    else
+    {
+        Compact(groupIdx, localIdx, k);
+    }
+}
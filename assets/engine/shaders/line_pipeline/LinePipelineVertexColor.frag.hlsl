@@ -0,0 +1,23 @@
+#include "../ColorUtils.hlsl"
+
+struct PSIn {
+    float4 position : SV_POSITION;
+    float4 color : COLOR0;
+};
+
+struct PSOut {
+    float4 color : SV_Target0;
+};
+
+PSOut main(PSIn input) {
+    PSOut output;
+
+    float3 color = input.color.rgb;
+    // exposure tone mapping
+    color = ApplyExposureToneMapping(color);
+    // Gamma correct
+    color = ApplyGammaCorrection(color); 
+
+    output.color = float4(color, input.color.a);
+    return output;
+}
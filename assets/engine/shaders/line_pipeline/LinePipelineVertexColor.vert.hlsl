@@ -0,0 +1,35 @@
+struct VSIn {
+    float3 position : POSITION0;
+    float4 color : COLOR0;
+};
+
+struct VSOut {
+    float4 position : SV_POSITION;
+    float4 color : COLOR0;
+};
+
+struct ViewProjectionBuffer {
+    float4x4 viewProjection;
+};
+
+ConstantBuffer <ViewProjectionBuffer> vpBuffer: register(b0, space0);
+
+struct PushConsts
+{
+    float4x4 model;
+};
+
+[[vk::push_constant]]
+cbuffer {
+    PushConsts pushConsts;
+};
+
+VSOut main(VSIn input) {
+    VSOut output;
+
+    float4x4 mvpMatrix = mul(vpBuffer.viewProjection, pushConsts.model);
+    output.position = mul(mvpMatrix, float4(input.position, 1.0));
+    output.color = input.color;
+
+    return output;
+}
@@ -2,36 +2,22 @@
 
 struct PSIn {
     float4 position : SV_POSITION;
+    float4 color : COLOR0;
 };
 
 struct PSOut {
     float4 color : SV_Target0;
 };
 
-struct PushConsts
-{    
-    float4x4 model;
-    float4 color;
-    float pointSize;
-    float placeholder0;
-    float placeholder1;
-    float placeholder2;
-};
-
-[[vk::push_constant]]
-cbuffer {
-    PushConsts pushConsts;
-};
-
 PSOut main(PSIn input) {
     PSOut output;
 
-    float3 color = pushConsts.color.rgb;
+    float3 color = input.color.rgb;
     // exposure tone mapping
     color = ApplyExposureToneMapping(color);
     // Gamma correct
     color = ApplyGammaCorrection(color); 
 
-    output.color = float4(color, pushConsts.color.a);
+    output.color = float4(color, input.color.a);
     return output;
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
+// Per instance, one instance is one point
 struct VSIn {
     float3 position : POSITION0;
+    float4 color : COLOR0;
+    float pointSize : TEXCOORD0;
 };
 
 struct VSOut {
     float4 position : SV_POSITION;
     [[vk::builtin("PointSize")]] float PSize : PSIZE;
+    float4 color : COLOR0;
 };
 
 struct ViewProjectionBuffer {
@@ -16,11 +20,6 @@ ConstantBuffer <ViewProjectionBuffer> mvpBuffer: register(b0, space0);
 struct PushConsts
 {    
     float4x4 model;
-    float4 color;
-    float pointSize;
-    float placeholder0;
-    float placeholder1;
-    float placeholder2;
 };
 
 [[vk::push_constant]]
@@ -33,7 +32,8 @@ VSOut main(VSIn input) {
 
     float4x4 mvpMatrix = mul(mvpBuffer.viewProjection, pushConsts.model);
     output.position = mul(mvpMatrix, float4(input.position, 1.0));
-    output.PSize = pushConsts.pointSize;
+    output.PSize = input.pointSize;
+    output.color = input.color;
 
     return output;
 }
\ No newline at end of file
@@ -7,6 +7,18 @@
 #include "BedrockAssert.hpp"
 #include "BedrockLog.hpp"
 
+#ifdef __PLATFORM_WIN__
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace MFA::File
 {
@@ -39,4 +51,96 @@ namespace MFA::File
         }
         return nullptr;
     }
+    Mapping::Mapping(std::string const & path)
+    {
+#ifdef __PLATFORM_WIN__
+        auto const file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        _file = file;
+
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(file, &size) == FALSE || size.QuadPart <= 0)
+        {
+            return;
+        }
+
+        _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping == nullptr)
+        {
+            return;
+        }
+
+        auto * ptr = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        _ptr = static_cast<uint8_t *>(ptr);
+        _len = static_cast<size_t>(size.QuadPart);
+#else
+        auto const file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return;
+        }
+
+        struct stat status{};
+        if (fstat(file, &status) == 0 && status.st_size > 0)
+        {
+            auto * ptr = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (ptr != MAP_FAILED)
+            {
+                _ptr = static_cast<uint8_t *>(ptr);
+                _len = static_cast<size_t>(status.st_size);
+            }
+        }
+
+        // The mapping keeps its own reference to the file
+        close(file);
+#endif
+    }
+
+    Mapping::~Mapping()
+    {
+#ifdef __PLATFORM_WIN__
+        if (_ptr != nullptr)
+        {
+            UnmapViewOfFile(_ptr);
+        }
+        if (_mapping != nullptr)
+        {
+            CloseHandle(_mapping);
+        }
+        if (_file != nullptr)
+        {
+            CloseHandle(_file);
+        }
+#else
+        if (_ptr != nullptr)
+        {
+            munmap(_ptr, _len);
+        }
+#endif
+    }
+
+    std::shared_ptr<Mapping> Map(std::string const & path)
+    {
+        auto mapping = std::make_shared<Mapping>(path);
+        if (mapping->IsValid() == false)
+        {
+            return nullptr;
+        }
+        return mapping;
+    }
 }
\ No newline at end of file
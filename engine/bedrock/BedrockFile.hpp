@@ -3,8 +3,33 @@
 #include <string>
 
 #include "BedrockMemory.hpp"
+#include "BedrockPlatforms.hpp"
 
 namespace MFA::File
 {
     std::shared_ptr<Blob> Read(std::string const & path);
+
+    // Read only view of a file that is mapped into memory, pages are loaded by the os on first access
+    class Mapping : public BaseBlob
+    {
+    public:
+
+        explicit Mapping(std::string const & path);
+
+        ~Mapping();
+
+        Mapping(Mapping const &) = delete;
+        Mapping & operator=(Mapping const &) = delete;
+
+    private:
+
+#ifdef __PLATFORM_WIN__
+        void * _file = nullptr;
+        void * _mapping = nullptr;
+#endif
+
+    };
+
+    // Returns nullptr if the file does not exist, is empty or can not be mapped
+    std::shared_ptr<Mapping> Map(std::string const & path);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <cstring>
 #include <memory>
+#include <type_traits>
 
 namespace MFA
 {
@@ -48,11 +49,12 @@ namespace MFA
     {
     public:
 
+        // Const data is accepted so that it can be used as the source of a copy, it must not be written through the alias
         template<typename T>
         explicit Alias(T * ptr, size_t const count)
     	{
             _len = sizeof(T) * count;
-            _ptr = reinterpret_cast<uint8_t *>(ptr);
+            _ptr = reinterpret_cast<uint8_t *>(const_cast<std::remove_const_t<T> *>(ptr));
         }
 
         template<typename T>
@@ -2,8 +2,11 @@
 
 #include "ThreadPool.hpp"
 
+#include <algorithm>
 #include <future>
+#ifdef _OPENMP
 #include <omp.h>
+#endif
 
 namespace MFA
 {
@@ -21,8 +24,11 @@ namespace MFA
             MFA_ASSERT(Instance == nullptr);
 
 			// 80 percent is the best ratio
-			omp_set_num_threads(static_cast<int>(static_cast<float>(std::thread::hardware_concurrency()) * 0.8f));
+			ompThreadCount = std::max(1, static_cast<int>(static_cast<float>(std::thread::hardware_concurrency()) * 0.8f));
+#ifdef _OPENMP
+			omp_set_num_threads(ompThreadCount);
 			MFA_LOG_INFO("Number of available workers are: %d", omp_get_max_threads());
+#endif
 
             Instance = this;
         }
@@ -41,8 +47,9 @@ namespace MFA
             };
             auto params = std::make_shared<Params>();
 
-            threadPool.AssignTask([task, params]()
+            threadPool.AssignTask([task, params, threadCount = ompThreadCount]()
                 {
+                    SetOmpThreadCount(threadCount);
                     task();
                     params->promise.set_value();
                 }
@@ -59,8 +66,9 @@ namespace MFA
             };
             auto params = std::make_shared<Params>();
 
-            threadPool.AssignTask([task, params]()
+            threadPool.AssignTask([task, params, threadCount = ompThreadCount]()
                 {
+                    SetOmpThreadCount(threadCount);
                     params->promise.set_value(task());
                 }
             );
@@ -83,8 +91,19 @@ namespace MFA
 
     private:
 
+        // The OpenMP thread count only applies to the thread that sets it, a parallel region inside a task would
+        // otherwise start a thread per hardware thread on every worker
+        static void SetOmpThreadCount([[maybe_unused]] int const threadCount)
+        {
+#ifdef _OPENMP
+            omp_set_num_threads(threadCount);
+#endif
+        }
+
         ThreadPool threadPool{};
 
+        int ompThreadCount = 1;
+
     };
 }
 
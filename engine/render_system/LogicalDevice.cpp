@@ -849,9 +849,10 @@ namespace MFA
                 graphicWaitSemaphores.emplace_back(computeSemaphore);
             }
             //std::vector<VkSemaphore> graphicWaitSemaphores{};
+            // Compute results can be vertices or the arguments of indirect draws
             std::vector<VkPipelineStageFlags> graphicWaitDstStageMask{
                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
             };
             std::vector<VkSemaphore> graphicSignalSemaphores{};
             if (hasComputeSubmission)
@@ -78,6 +78,15 @@ namespace MFA::RenderBackend
         VkDeviceSize const size
     );
 
+	static void CopyBuffer(
+        VkCommandBuffer commandBuffer,
+        VkBuffer sourceBuffer,
+        VkBuffer destinationBuffer,
+        VkDeviceSize sourceOffset,
+        VkDeviceSize destinationOffset,
+        VkDeviceSize size
+    );
+
 
     //-------------------------------------------------------------------------------------------------
 
@@ -2668,9 +2677,47 @@ namespace MFA::RenderBackend
 
     //-------------------------------------------------------------------------------------------------
 
+    static void CopyBuffer(
+        VkCommandBuffer commandBuffer,
+        VkBuffer sourceBuffer,
+        VkBuffer destinationBuffer,
+        VkDeviceSize const sourceOffset,
+        VkDeviceSize const destinationOffset,
+        VkDeviceSize const size
+    )
+    {
+        VkBufferCopy const copyRegion{
+            .srcOffset = sourceOffset,
+            .dstOffset = destinationOffset,
+            .size = size
+        };
+
+        vkCmdCopyBuffer(
+            commandBuffer,
+            sourceBuffer,
+            destinationBuffer,
+            1,
+            &copyRegion
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void CopyDataToHostVisibleBuffer(
+        VkDevice device,
+        VkDeviceMemory bufferMemory,
+        BaseBlob const & dataBlob
+    )
+    {
+        CopyDataToHostVisibleBuffer(device, bufferMemory, 0, dataBlob);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     void CopyDataToHostVisibleBuffer(
         VkDevice device,
         VkDeviceMemory bufferMemory,
+        size_t const offset,
         BaseBlob const & dataBlob
     )
     {
@@ -2679,7 +2726,7 @@ namespace MFA::RenderBackend
         MapHostVisibleMemory(
             device,
             bufferMemory,
-            0,
+            offset,
             dataBlob.Len(),
             &tempBufferData
         );
@@ -2718,6 +2765,42 @@ namespace MFA::RenderBackend
 
     //-------------------------------------------------------------------------------------------------
 
+    void UpdateHostVisibleBuffer(
+        VkDevice device,
+        RT::BufferAndMemory const& buffer,
+        size_t const offset,
+        BaseBlob const& data
+    )
+    {
+        MFA_ASSERT(offset + data.Len() <= buffer.size);
+        CopyDataToHostVisibleBuffer(device, buffer.memory, offset, data);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void UpdateLocalBuffer(
+        VkCommandBuffer commandBuffer,
+        RT::BufferAndMemory const& buffer,
+        RT::BufferAndMemory const& stageBuffer,
+        VkDeviceSize const stageOffset,
+        VkDeviceSize const offset,
+        VkDeviceSize const size
+    )
+    {
+        MFA_ASSERT(offset + size <= buffer.size);
+        MFA_ASSERT(stageOffset + size <= stageBuffer.size);
+        CopyBuffer(
+            commandBuffer,
+            stageBuffer.buffer,
+            buffer.buffer,
+            stageOffset,
+            offset,
+            size
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     std::shared_ptr<RT::BufferAndMemory> CreateVertexBuffer(
         VkDevice device,
         VkPhysicalDevice physicalDevice,
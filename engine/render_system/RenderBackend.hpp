@@ -566,6 +566,24 @@ namespace MFA::RenderBackend
         RT::BufferAndMemory const& buffer,
         RT::BufferAndMemory const& stageBuffer
     );
+
+    // Copies data to [offset, offset + data.Len()) of a host visible buffer
+    void UpdateHostVisibleBuffer(
+        VkDevice device,
+        RT::BufferAndMemory const& buffer,
+        size_t offset,
+        BaseBlob const& data
+    );
+
+    // Copies [stageOffset, stageOffset + size) of the stage buffer to [offset, offset + size) of the local buffer
+    void UpdateLocalBuffer(
+        VkCommandBuffer commandBuffer,
+        RT::BufferAndMemory const& buffer,
+        RT::BufferAndMemory const& stageBuffer,
+        VkDeviceSize stageOffset,
+        VkDeviceSize offset,
+        VkDeviceSize size
+    );
     
     std::shared_ptr<RT::BufferAndMemory> CreateVertexBuffer(
         VkDevice device,
@@ -619,6 +637,13 @@ namespace MFA::RenderBackend
         BaseBlob const & dataBlob
     );
 
+    void CopyDataToHostVisibleBuffer(
+        VkDevice device,
+        VkDeviceMemory bufferMemory,
+        size_t offset,
+        BaseBlob const & dataBlob
+    );
+
     void PushConstants(
         RT::CommandRecordState& recordState,
         VkPipelineLayout pipeline_layout,
@@ -213,7 +213,10 @@ namespace MFA::RenderTypes
 
 	BufferAndMemory::~BufferAndMemory()
 	{
-		vkDeviceWaitIdle(LogicalDevice::Instance->GetVkDevice());
+		if (isIdle == false)
+		{
+			vkDeviceWaitIdle(LogicalDevice::Instance->GetVkDevice());
+		}
 		RB::DestroyBuffer(LogicalDevice::Instance->GetVkDevice(), *this);
 	}
 
@@ -228,6 +228,8 @@ namespace MFA
             const VkBuffer buffer;
             const VkDeviceMemory memory;
             VkDeviceSize const size;
+            // Set by an owner that knows the device has finished with the buffer, the destructor then skips the wait
+            bool isIdle = false;
 
             explicit BufferAndMemory(
                 VkBuffer buffer_,
@@ -14,11 +14,14 @@ namespace MFA
     LinePipeline::LinePipeline(
         std::shared_ptr<DisplayRenderPass> displayRenderPass,
         std::shared_ptr<RT::BufferGroup> viewProjectionBuffer,
-        int const maxSets
+        int const maxSets,
+        Options const & options
     ) 
     {
         mDisplayRenderPass = std::move(displayRenderPass);
 
+        mOptions = options;
+
         mViewProjBuffer = std::move(viewProjectionBuffer);
 
         mDescriptorPool = RB::CreateDescriptorPool(
@@ -81,6 +84,13 @@ namespace MFA
 
     //-------------------------------------------------------------------------------------------------
 
+    LinePipeline::Options const & LinePipeline::GetOptions() const
+    {
+        return mOptions;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     void LinePipeline::CreateDescriptorSetLayout()
     {
         std::vector<VkDescriptorSetLayoutBinding> bindings{};
@@ -108,7 +118,9 @@ namespace MFA
     {
         // Vertex shader
         auto cpuVertexShader = Importer::ShaderFromSPV(
-            Path::Instance->Get("engine/shaders/line_pipeline/LinePipeline.vert.spv"),
+            Path::Instance->Get(mOptions.vertexColor == true
+                ? "engine/shaders/line_pipeline/LinePipelineVertexColor.vert.spv"
+                : "engine/shaders/line_pipeline/LinePipeline.vert.spv"),
             VK_SHADER_STAGE_VERTEX_BIT,
             "main"
         );
@@ -119,7 +131,9 @@ namespace MFA
 
         // Fragment shader
         auto cpuFragmentShader = Importer::ShaderFromSPV(
-            Path::Instance->Get("engine/shaders/line_pipeline/LinePipeline.frag.spv"),
+            Path::Instance->Get(mOptions.vertexColor == true
+                ? "engine/shaders/line_pipeline/LinePipelineVertexColor.frag.spv"
+                : "engine/shaders/line_pipeline/LinePipeline.frag.spv"),
             VK_SHADER_STAGE_FRAGMENT_BIT,
             "main"
         );
@@ -132,22 +146,33 @@ namespace MFA
 
         VkVertexInputBindingDescription const bindingDescription{
             .binding = 0,
-            .stride = sizeof(Vertex),
+            .stride = mOptions.vertexColor == true ? sizeof(ColorVertex) : sizeof(Vertex),
             .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
         };
 
         std::vector<VkVertexInputAttributeDescription> inputAttributeDescriptions{};
         // Position
+        static_assert(offsetof(Vertex, position) == offsetof(ColorVertex, position));
         inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
             .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
             .binding = 0,
             .format = VK_FORMAT_R32G32B32_SFLOAT,
             .offset = offsetof(Vertex, position),
         });
+        if (mOptions.vertexColor == true)
+        {
+            // Color
+            inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+                .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+                .binding = 0,
+                .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+                .offset = offsetof(ColorVertex, color),
+            });
+        }
 
         RB::CreateGraphicPipelineOptions pipelineOptions{};
         pipelineOptions.useStaticViewportAndScissor = false;
-        pipelineOptions.primitiveTopology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+        pipelineOptions.primitiveTopology = mOptions.primitiveTopology;
         // TODO I think we should submit each pipeline . Each one should have independent depth buffer 
         pipelineOptions.rasterizationSamples = LogicalDevice::Instance->GetMaxSampleCount();            // TODO Find a way to set sample count to 1. We only need MSAA for pbr-pipeline
         pipelineOptions.cullMode = VK_CULL_MODE_NONE;
@@ -16,6 +16,13 @@ namespace MFA
             glm::vec3 position{};
         };
 
+        // Vertex of a pipeline that is created with Options::vertexColor
+        struct ColorVertex
+        {
+            glm::vec3 position{};
+            glm::vec4 color{};
+        };
+
         struct ViewProjection
         {
             glm::mat4 matrix {};
@@ -24,13 +31,21 @@ namespace MFA
         struct PushConstants
         {
             glm::mat4 model;
-            glm::vec4 color;
+            glm::vec4 color;        // Ignored when the color comes from the vertices
+        };
+
+        struct Options
+        {
+            // Reads the color of each vertex from ColorVertex instead of using PushConstants::color for the whole draw
+            bool vertexColor = false;
+            VkPrimitiveTopology primitiveTopology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
         };
 
         explicit LinePipeline(
             std::shared_ptr<DisplayRenderPass> displayRenderPass,
             std::shared_ptr<RT::BufferGroup> viewProjectionBuffer,
-            int maxSets
+            int maxSets,
+            Options const & options
         );
 
         ~LinePipeline();
@@ -42,6 +57,9 @@ namespace MFA
 
         void SetPushConstants(RT::CommandRecordState& recordState, PushConstants pushConstants) const;
 
+        [[nodiscard]]
+        Options const & GetOptions() const;
+
     private:
 
         void CreateDescriptorSetLayout();
@@ -58,6 +76,8 @@ namespace MFA
         RT::DescriptorSetGroup mDescriptorSetGroup{};
 
         std::shared_ptr<DisplayRenderPass> mDisplayRenderPass {};
+
+        Options mOptions {};
         
     };
 }
@@ -73,7 +73,7 @@ namespace MFA
         RB::PushConstants(
             recordState,
             mPipeline->pipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            VK_SHADER_STAGE_VERTEX_BIT,
             0,
             Alias(pushConstants)
         );
@@ -132,8 +132,8 @@ namespace MFA
 
         VkVertexInputBindingDescription const bindingDescription{
             .binding = 0,
-            .stride = sizeof(Vertex),
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+            .stride = sizeof(Instance),
+            .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
         };
 
         std::vector<VkVertexInputAttributeDescription> inputAttributeDescriptions{};
@@ -142,7 +142,21 @@ namespace MFA
             .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
             .binding = 0,
             .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, position),
+            .offset = offsetof(Instance, position),
+            });
+        // Color
+        inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+            .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+            .binding = 0,
+            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset = offsetof(Instance, color),
+            });
+        // Point size
+        inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+            .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+            .binding = 0,
+            .format = VK_FORMAT_R32_SFLOAT,
+            .offset = offsetof(Instance, pointSize),
             });
 
         RB::CreateGraphicPipelineOptions pipelineOptions{};
@@ -156,7 +170,7 @@ namespace MFA
         // pipeline layout
         std::vector<VkPushConstantRange> const pushConstantRanges{
             VkPushConstantRange {
-                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT,
+                .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                 .offset = 0,
                 .size = sizeof(PushConstants),
             }
@@ -11,9 +11,12 @@ namespace MFA
     {
     public:
 
-        struct Vertex
+        // Each point is an instance of a single vertex, it reads all of its attributes from the instance buffer
+        struct Instance
         {
             glm::vec3 position{};
+            float pointSize = 1.0f;
+            glm::vec4 color{};
         };
 
         struct ViewProjection
@@ -21,16 +24,10 @@ namespace MFA
             glm::mat4 matrix{};
         };
 
+        // Applies to every point of the draw
         struct PushConstants
         {
             glm::mat4 model;
-
-            glm::vec4 color;
-
-            float pointSize = 1.0f;
-            float placeholder0;
-            float placeholder1;
-            float placeholder2;
         };
 
         explicit PointPipeline(
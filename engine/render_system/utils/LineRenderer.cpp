@@ -2,8 +2,10 @@
 
 #include "LogicalDevice.hpp"
 #include "pipeline/LinePipeline.hpp"
+#include "BedrockAssert.hpp"
 #include "BedrockMath.hpp"
-#include "BufferTracker.hpp"
+
+#include <algorithm>
 
 namespace MFA
 {
@@ -12,138 +14,132 @@ namespace MFA
 
 	LineRenderer::LineRenderer(std::shared_ptr<MFA::LinePipeline> linePipeline)
 		: _linePipeline(std::move(linePipeline))
+	{
+		MFA_ASSERT(_linePipeline->GetOptions().vertexColor == true);
+		MFA_ASSERT(_linePipeline->GetOptions().primitiveTopology == VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void LineRenderer::Add(
+		glm::vec3 const& from,
+		glm::vec3 const& to,
+		glm::vec4 const& color
+	)
+	{
+		_vertices.emplace_back(LinePipeline::ColorVertex{ .position = from, .color = color });
+		_vertices.emplace_back(LinePipeline::ColorVertex{ .position = to, .color = color });
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void LineRenderer::Draw(MFA::RT::CommandRecordState& recordState)
 	{
 		using namespace MFA;
 
+		ReleaseRetiredRing(recordState.frameIndex);
+
+		_stats.segmentCount = static_cast<int>(_vertices.size() / 2);
+		_stats.streamedSize = 0;
+		if (_vertices.empty() == true)
 		{
-			auto const vector = _endPos - _startPos;
-			_length = glm::length(vector);
-			_direction = vector / _length;
-			_center = (_endPos + _startPos) * 0.5f;
+			return;
 		}
 
-		std::vector<glm::vec3> vertices{
-			_startPos,
-			_endPos,
-		};
-		std::vector<uint16_t> indices{ 0, 1 };
+		Alias const verticesAlias{ _vertices.data(), _vertices.size() };
+		Reserve(verticesAlias.Len(), recordState.frameIndex);
 
-		Alias const verticesAlias{ vertices.data(), vertices.size() };
-		Alias const indicesAlias{ indices.data(), indices.size() };
-
-		auto* device = LogicalDevice::Instance;
-
-		auto commandBuffer = RB::BeginSingleTimeCommand(
-			device->GetVkDevice(),
-			device->GetGraphicCommandPool()
-		);
-		auto vertexStageBuffer = RB::CreateStageBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			verticesAlias.Len(),
-			1
-		);
-		_vertexBuffer = RB::CreateVertexBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			commandBuffer,
-			*vertexStageBuffer->buffers[0],
+		// The slice of this frame was last read by the frame that used the same index, which has finished by now
+		auto const sliceOffset = recordState.frameIndex * _sliceCapacity;
+		auto const& ringBuffer = *_ring->buffers[0];
+		RB::UpdateHostVisibleBuffer(
+			LogicalDevice::Instance->GetVkDevice(),
+			ringBuffer,
+			sliceOffset,
 			verticesAlias
 		);
-		auto indexStageBuffer = RB::CreateStageBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			indicesAlias.Len(),
-			1
+		_stats.streamedSize = verticesAlias.Len();
+
+		_linePipeline->BindPipeline(recordState);
+
+		_linePipeline->SetPushConstants(
+			recordState,
+			LinePipeline::PushConstants{
+				.model = glm::identity<glm::mat4>()
+			}
 		);
-		_indexBuffer = RB::CreateIndexBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			commandBuffer,
-			*indexStageBuffer->buffers[0],
-			indicesAlias
+
+		RB::BindVertexBuffer(
+			recordState,
+			ringBuffer,
+			0,
+			sliceOffset
 		);
-		RB::EndAndSubmitSingleTimeCommand(
-			device->GetVkDevice(),
-			device->GetGraphicCommandPool(),
-			device->GetGraphicQueue(),
-			commandBuffer
+
+		vkCmdDraw(
+			recordState.commandBuffer,
+			static_cast<uint32_t>(_vertices.size()),
+			1,
+			0,
+			0
 		);
 
-		_indexCount = indices.size();
+		_vertices.clear();
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	void LineRenderer::Draw(
-		MFA::RT::CommandRecordState& recordState,
-		glm::vec3 const& from0,
-		glm::vec3 const& to0,
-		glm::vec4 const& color
-	) const
+	LineRenderer::Stats const& LineRenderer::GetStats() const
 	{
-		using namespace MFA;
-
-		_linePipeline->BindPipeline(recordState);
+		return _stats;
+	}
 
-		auto from = from0;
-		auto to = to0;
+	//-------------------------------------------------------------------------------------------------
 
-		if (to.x < from.x)
+	void LineRenderer::ReleaseRetiredRing(uint32_t const frameIndex)
+	{
+		if (frameIndex >= _retiredRings.size() || _retiredRings[frameIndex] == nullptr)
+		{
+			return;
+		}
+		// The fences of every slot were waited on since this ring was retired, so no frame draws from it anymore
+		for (auto const& buffer : _retiredRings[frameIndex]->buffers)
 		{
-			auto temp = from;
-			from = to;
-			to = temp;
+			buffer->isIdle = true;
 		}
+		_retiredRings[frameIndex].reset();
+	}
 
-		glm::vec3 const targetVector = to - from;
-		float const targetLength = glm::length(targetVector);
+	//-------------------------------------------------------------------------------------------------
 
-		if (targetLength > 0.0f)
+	void LineRenderer::Reserve(VkDeviceSize const sliceCapacity, uint32_t const frameIndex)
+	{
+		if (sliceCapacity <= _sliceCapacity)
 		{
-			float const scale = targetLength / _length;
-			glm::vec3 const targetCenter = (from + to) * 0.5f;
-
-			auto const targetDirection = targetVector / targetLength;
-
-			auto const rotation = Math::FindRotation(_direction, targetDirection);
-			auto const rotationMat = glm::toMat4(rotation);
-			auto const translateMat = Math::Translate(targetCenter - _center);
-			auto const scaleMat = Math::Scale(glm::vec3{ scale, 1.0f, 1.0f });
-
-			glm::mat4 matrix = translateMat
-				* rotationMat
-				* scaleMat;
-
-			_linePipeline->SetPushConstants(
-				recordState,
-				LinePipeline::PushConstants{
-					.model = matrix,
-					.color = color
-				}
-			);
-
-			RB::BindIndexBuffer(
-				recordState,
-				*_indexBuffer,
-				0,
-				VK_INDEX_TYPE_UINT16
-			);
-
-			RB::BindVertexBuffer(
-				recordState,
-				*_vertexBuffer,
-				0,
-				0
-			);
-
-			RB::DrawIndexed(
-				recordState,
-				_indexCount
-			);
+			return;
 		}
+
+		auto* device = LogicalDevice::Instance;
+
+		// The frames in flight may still draw from the old ring, Draw already released what this slot retired before
+		_retiredRings.resize(device->GetMaxFramePerFlight());
+		MFA_ASSERT(_retiredRings[frameIndex] == nullptr);
+		_retiredRings[frameIndex] = std::move(_ring);
+
+		// Slices start at a multiple of 256 bytes, which satisfies the alignment of any vertex buffer offset
+		_sliceCapacity = std::max({ sliceCapacity, _sliceCapacity * 2, static_cast<VkDeviceSize>(4096) });
+		_sliceCapacity = (_sliceCapacity + 255) / 256 * 256;
+		_ring = RB::CreateBufferGroup(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			_sliceCapacity * device->GetMaxFramePerFlight(),
+			1,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		);
+		++_stats.reallocationCount;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-}
\ No newline at end of file
+}
@@ -3,31 +3,58 @@
 #include "pipeline/LinePipeline.hpp"
 #include "BedrockMath.hpp"
 
+#include <vector>
+
 namespace MFA
 {
 
+    // Immediate mode batch of segments. Segments are added during the frame and streamed through a host visible ring
+    // with one slice per frame in flight, then drawn together with a single draw. linePipeline has to be created with
+    // vertexColor and VK_PRIMITIVE_TOPOLOGY_LINE_LIST.
     class LineRenderer
     {
     public:
 
+        struct Stats
+        {
+            int segmentCount = 0;               // Drawn by the last Draw
+            VkDeviceSize streamedSize = 0;      // Bytes written to the ring by the last Draw
+            int reallocationCount = 0;
+        };
+
         explicit LineRenderer(std::shared_ptr<MFA::LinePipeline> linePipeline);
 
-        void Draw(
-            MFA::RT::CommandRecordState& recordState,
+        void Add(
             glm::vec3 const& from,
             glm::vec3 const& to,
             glm::vec4 const& color = { 0.0f, 1.0f, 0.0f, 1.0f }
-        ) const;
+        );
+
+        // Draws the segments that were added since the last call and clears them. Call it at most once per frame,
+        // the slice of a frame is overwritten by the next call with the same frame index
+        void Draw(MFA::RT::CommandRecordState& recordState);
+
+        [[nodiscard]]
+        Stats const& GetStats() const;
+
+    private:
+
+        void ReleaseRetiredRing(uint32_t frameIndex);
+
+        void Reserve(VkDeviceSize sliceCapacity, uint32_t frameIndex);
 
         std::shared_ptr<MFA::LinePipeline> _linePipeline{};
-        std::shared_ptr<MFA::RT::BufferAndMemory> _vertexBuffer{};
-        std::shared_ptr<MFA::RT::BufferAndMemory> _indexBuffer{};
-        glm::vec3 _startPos{ -0.5f, 0.0f, 0.0f };
-        glm::vec3 _endPos{ 0.5f, 0.0f, 0.0f };
-        glm::vec3 _direction{};
-        glm::vec3 _center{};
-        float _length{};
-        int _indexCount{};
+
+        std::vector<LinePipeline::ColorVertex> _vertices{};
+
+        std::shared_ptr<MFA::RT::BufferGroup> _ring{};
+        VkDeviceSize _sliceCapacity = 0;
+
+        // Rings that were replaced by larger ones, at the index of the frame slot that replaced them. They are released
+        // when that slot comes round again, by then every frame that drew from them has finished
+        std::vector<std::shared_ptr<MFA::RT::BufferGroup>> _retiredRings{};
+
+        Stats _stats{};
     };
 
-}
\ No newline at end of file
+}
@@ -2,8 +2,10 @@
 
 #include "LogicalDevice.hpp"
 #include "pipeline/PointPipeline.hpp"
+#include "BedrockAssert.hpp"
 #include "BedrockMath.hpp"
-#include "BufferTracker.hpp"
+
+#include <algorithm>
 
 namespace MFA
 {
@@ -12,101 +14,115 @@ namespace MFA
 
 	PointRenderer::PointRenderer(std::shared_ptr<MFA::PointPipeline> pointPipeline)
 		: _pointPipeline(std::move(pointPipeline))
-	{
-		using namespace MFA;
-
-		std::vector<glm::vec3> vertices{ {0.0f, 0.0f, 0.0f} };
-		std::vector<uint16_t> indices{ 0 };
-
-		Alias const verticesAlias{ vertices.data(), vertices.size() };
-		Alias const indicesAlias{ indices.data(), indices.size() };
-
-		auto* device = LogicalDevice::Instance;
+	{}
 
-		auto commandBuffer = RB::BeginSingleTimeCommand(
-			device->GetVkDevice(),
-			device->GetGraphicCommandPool()
-		);
-		auto const vertexStageBuffer = RB::CreateStageBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			verticesAlias.Len(),
-			1
-		);
-		_vertexBuffer = RB::CreateVertexBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			commandBuffer,
-			*vertexStageBuffer->buffers[0],
-			verticesAlias
-		);
-		auto const indexStageBuffer = RB::CreateStageBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			indicesAlias.Len(),
-			1
-		);
-		_indexBuffer = RB::CreateIndexBuffer(
-			device->GetVkDevice(),
-			device->GetPhysicalDevice(),
-			commandBuffer,
-			*indexStageBuffer->buffers[0],
-			indicesAlias
-		);
-		RB::EndAndSubmitSingleTimeCommand(
-			device->GetVkDevice(),
-			device->GetGraphicCommandPool(),
-			device->GetGraphicQueue(),
-			commandBuffer
-		);
+	//-------------------------------------------------------------------------------------------------
 
-		_indexCount = indices.size();
+	void PointRenderer::Add(
+		glm::vec3 const& position,
+		glm::vec4 const& color,
+		float const pointSize
+	)
+	{
+		_instances.emplace_back(PointPipeline::Instance{
+			.position = position,
+			.pointSize = pointSize,
+			.color = color
+		});
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	void PointRenderer::Draw(
-		MFA::RT::CommandRecordState& recordState,
-		glm::vec3 const& position,
-		glm::vec4 const& color,
-		float pointSize
-	) const
+	void PointRenderer::Draw(MFA::RT::CommandRecordState& recordState)
 	{
 		using namespace MFA;
 
-		_pointPipeline->BindPipeline(recordState);
+		ReleaseRetiredBuffers(recordState.frameIndex);
+
+		if (_instances.empty() == true)
+		{
+			return;
+		}
+
+		auto const instanceCount = static_cast<int>(_instances.size());
+		Reserve(instanceCount, recordState.frameIndex);
 
-		glm::mat4 matrix = Math::Translate(position);
+		auto const& instanceBuffer = *_instanceBuffers->buffers[recordState.frameIndex];
+		RB::UpdateHostVisibleBuffer(
+			LogicalDevice::Instance->GetVkDevice(),
+			instanceBuffer,
+			Alias{ _instances.data(), _instances.size() }
+		);
+		_instances.clear();
+
+		_pointPipeline->BindPipeline(recordState);
 
 		_pointPipeline->SetPushConstants(
 			recordState,
 			PointPipeline::PushConstants{
-				.model = matrix,
-				.color = color,
-				.pointSize = pointSize
+				.model = glm::identity<glm::mat4>()
 			}
 		);
 
-		RB::BindIndexBuffer(
+		RB::BindVertexBuffer(
 			recordState,
-			*_indexBuffer,
+			instanceBuffer,
 			0,
-			VK_INDEX_TYPE_UINT16
+			0
 		);
 
-		RB::BindVertexBuffer(
-			recordState,
-			*_vertexBuffer,
+		vkCmdDraw(
+			recordState.commandBuffer,
+			1,
+			instanceCount,
 			0,
 			0
 		);
+	}
 
-		RB::DrawIndexed(
-			recordState,
-			_indexCount
+	//-------------------------------------------------------------------------------------------------
+
+	void PointRenderer::ReleaseRetiredBuffers(uint32_t const frameIndex)
+	{
+		if (frameIndex >= _retiredInstanceBuffers.size() || _retiredInstanceBuffers[frameIndex] == nullptr)
+		{
+			return;
+		}
+		// The fences of every slot were waited on since these buffers were retired, so no frame draws from them anymore
+		for (auto const& buffer : _retiredInstanceBuffers[frameIndex]->buffers)
+		{
+			buffer->isIdle = true;
+		}
+		_retiredInstanceBuffers[frameIndex].reset();
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void PointRenderer::Reserve(int const instanceCount, uint32_t const frameIndex)
+	{
+		if (instanceCount <= _instanceCapacity)
+		{
+			return;
+		}
+
+		auto* device = LogicalDevice::Instance;
+
+		// The frames in flight may still draw from the old buffers, Draw already released what this slot retired before
+		_retiredInstanceBuffers.resize(device->GetMaxFramePerFlight());
+		MFA_ASSERT(_retiredInstanceBuffers[frameIndex] == nullptr);
+		_retiredInstanceBuffers[frameIndex] = std::move(_instanceBuffers);
+
+		_instanceCapacity = std::max({ instanceCount, _instanceCapacity * 2, 64 });
+		_instanceBuffers = RB::CreateBufferGroup(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			_instanceCapacity * sizeof(PointPipeline::Instance),
+			device->GetMaxFramePerFlight(),
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
 		);
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-}
\ No newline at end of file
+}
@@ -3,24 +3,42 @@
 #include "pipeline/PointPipeline.hpp"
 #include "BedrockMath.hpp"
 
+#include <vector>
+
 namespace MFA
 {
+    // Collects the points of a frame and draws all of them with a single instanced draw
     class PointRenderer
     {
     public:
 
         explicit PointRenderer(std::shared_ptr<MFA::PointPipeline> pointPipeline);
 
-        void Draw(
-            MFA::RT::CommandRecordState& recordState,
+        void Add(
             glm::vec3 const& position,
             glm::vec4 const& color = { 1.0f, 0.0f, 0.0f, 1.0f },
             float pointSize = 10.0f
-        ) const;
+        );
+
+        // Draws the points that were added since the last call and clears them
+        void Draw(MFA::RT::CommandRecordState& recordState);
+
+    private:
+
+        void ReleaseRetiredBuffers(uint32_t frameIndex);
+
+        void Reserve(int instanceCount, uint32_t frameIndex);
 
         std::shared_ptr<MFA::PointPipeline> _pointPipeline{};
-        std::shared_ptr<MFA::RT::BufferAndMemory> _vertexBuffer{};
-        std::shared_ptr<MFA::RT::BufferAndMemory> _indexBuffer{};
-        int _indexCount{};
+
+        std::vector<PointPipeline::Instance> _instances{};
+
+        // One buffer per frame in flight, the host writes the buffer of a frame once that frame has finished
+        std::shared_ptr<MFA::RT::BufferGroup> _instanceBuffers{};
+        int _instanceCapacity = 0;
+
+        // Buffers that were replaced by larger ones, at the index of the frame slot that replaced them. They are
+        // released when that slot comes round again, by then every frame that drew from them has finished
+        std::vector<std::shared_ptr<MFA::RT::BufferGroup>> _retiredInstanceBuffers{};
     };
 }
@@ -0,0 +1,183 @@
+#include "VertexArena.hpp"
+
+#include "LogicalDevice.hpp"
+#include "RenderBackend.hpp"
+#include "BedrockAssert.hpp"
+
+#include <algorithm>
+
+namespace MFA
+{
+
+	//-------------------------------------------------------------------------------------------------
+
+	VertexArena::VertexArena(VkDeviceSize const initialCapacity)
+		: _initialCapacity(initialCapacity)
+	{}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void VertexArena::Update(
+		RT::CommandRecordState const & recordState,
+		BaseBlob const & data,
+		VkDeviceSize dirtyBegin,
+		VkDeviceSize dirtyEnd
+	)
+	{
+		MFA_ASSERT(dirtyBegin <= dirtyEnd);
+		MFA_ASSERT(dirtyEnd <= data.Len());
+
+		_size = data.Len();
+		_stats.lastUploadSize = 0;
+		if (_size == 0)
+		{
+			return;
+		}
+
+		// A new buffer starts out empty, so all of the content has to be copied into it
+		if (Capacity() < _size)
+		{
+			Reserve(_size);
+			dirtyBegin = 0;
+			dirtyEnd = _size;
+		}
+
+		auto const uploadSize = dirtyEnd - dirtyBegin;
+		if (uploadSize == 0)
+		{
+			return;
+		}
+		_stats.lastUploadSize = uploadSize;
+		_stats.totalUploadSize += uploadSize;
+
+		ReserveStage(uploadSize);
+
+		auto * device = LogicalDevice::Instance;
+		auto const & stageBuffer = *_stageRing->buffers[0];
+		auto const stageOffset = recordState.frameIndex * _stageSliceCapacity;
+
+		// The slice of this frame was last read by the frame that used the same index, which has finished by now
+		RB::UpdateHostVisibleBuffer(
+			device->GetVkDevice(),
+			stageBuffer,
+			stageOffset,
+			Alias{ data.Ptr() + dirtyBegin, static_cast<size_t>(uploadSize) }
+		);
+
+		// Earlier frames may still draw from the range that is overwritten
+		VkBufferMemoryBarrier const beforeCopy{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+			.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.buffer = _buffer->buffer,
+			.offset = dirtyBegin,
+			.size = uploadSize
+		};
+		RB::PipelineBarrier(
+			recordState.commandBuffer,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			1,
+			&beforeCopy
+		);
+
+		RB::UpdateLocalBuffer(
+			recordState.commandBuffer,
+			*_buffer,
+			stageBuffer,
+			stageOffset,
+			dirtyBegin,
+			uploadSize
+		);
+
+		VkBufferMemoryBarrier const afterCopy{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.buffer = _buffer->buffer,
+			.offset = dirtyBegin,
+			.size = uploadSize
+		};
+		RB::PipelineBarrier(
+			recordState.commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			1,
+			&afterCopy
+		);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	std::shared_ptr<RT::BufferAndMemory> const & VertexArena::Buffer() const
+	{
+		return _buffer;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	VkDeviceSize VertexArena::Size() const
+	{
+		return _size;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	VkDeviceSize VertexArena::Capacity() const
+	{
+		return _buffer != nullptr ? _buffer->size : 0;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	VertexArena::Stats const & VertexArena::GetStats() const
+	{
+		return _stats;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void VertexArena::Reserve(VkDeviceSize const capacity)
+	{
+		auto * device = LogicalDevice::Instance;
+
+		// Released first to lower the peak, destroying a buffer waits until the device no longer uses it
+		auto const newCapacity = std::max({ capacity, Capacity() * 2, _initialCapacity });
+		_buffer.reset();
+		_buffer = RB::CreateVertexBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			newCapacity
+		);
+		++_stats.reallocationCount;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	void VertexArena::ReserveStage(VkDeviceSize const sliceCapacity)
+	{
+		if (sliceCapacity <= _stageSliceCapacity)
+		{
+			return;
+		}
+
+		auto * device = LogicalDevice::Instance;
+
+		_stageSliceCapacity = std::max({ sliceCapacity, _stageSliceCapacity * 2, _initialCapacity });
+		_stageRing.reset();
+		_stageRing = RB::CreateStageBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			_stageSliceCapacity * device->GetMaxFramePerFlight(),
+			1
+		);
+		++_stats.reallocationCount;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+#include "BedrockMemory.hpp"
+
+#include <memory>
+
+namespace MFA
+{
+    // Device local vertex buffer that is updated in place. Capacity grows geometrically, so a buffer that keeps growing
+    // is only reallocated a logarithmic number of times. Each frame in flight stages its copy in its own slice of one
+    // host visible ring, so a frame never overwrites stage memory that an earlier frame is still copying from.
+    class VertexArena
+    {
+    public:
+
+        struct Stats
+        {
+            int reallocationCount = 0;          // Vertex buffer and stage ring together
+            VkDeviceSize lastUploadSize = 0;
+            VkDeviceSize totalUploadSize = 0;
+        };
+
+        explicit VertexArena(VkDeviceSize initialCapacity = 0);
+
+        // data is the whole content, only [dirtyBegin, dirtyEnd) bytes of it are copied unless the arena had to grow.
+        // The copy is recorded on the command buffer of recordState, so it has to happen outside of a render pass
+        void Update(
+            RT::CommandRecordState const & recordState,
+            BaseBlob const & data,
+            VkDeviceSize dirtyBegin,
+            VkDeviceSize dirtyEnd
+        );
+
+        // Null until the first Update
+        [[nodiscard]]
+        std::shared_ptr<RT::BufferAndMemory> const & Buffer() const;
+
+        // Bytes of content, the buffer may be larger
+        [[nodiscard]]
+        VkDeviceSize Size() const;
+
+        [[nodiscard]]
+        VkDeviceSize Capacity() const;
+
+        [[nodiscard]]
+        Stats const & GetStats() const;
+
+    private:
+
+        void Reserve(VkDeviceSize capacity);
+
+        void ReserveStage(VkDeviceSize sliceCapacity);
+
+        VkDeviceSize _initialCapacity = 0;
+        VkDeviceSize _size = 0;
+        std::shared_ptr<RT::BufferAndMemory> _buffer{};
+
+        std::shared_ptr<RT::BufferGroup> _stageRing{};
+        VkDeviceSize _stageSliceCapacity = 0;
+
+        Stats _stats{};
+    };
+}
@@ -5,6 +5,9 @@
 using namespace MFA;
 
 static constexpr float DefaultZ = 0.5f;
+// Every CoarseStride-th sample is evaluated while dragging, the rest is refined within RefineBudget per frame
+static constexpr int CoarseStride = 8;
+static constexpr std::chrono::steady_clock::duration RefineBudget = std::chrono::milliseconds(4);
 
 //-----------------------------------------------------
 
@@ -13,6 +16,7 @@ CinpactApp::CinpactApp()
     MFA_LOG_DEBUG("Loading...");
 
     path = Path::Instantiate();
+    jobSystem = JobSystem::Instantiate();
 
     LogicalDevice::InitParams params
     {
@@ -46,16 +50,31 @@ CinpactApp::CinpactApp()
         device->GetMaxFramePerFlight()
     );
 
-    cameraBufferTracker = std::make_shared<HostVisibleBufferTracker<glm::mat4>>(cameraBuffer, glm::identity<glm::mat4>());
+    cameraBufferTracker = std::make_shared<HostVisibleBufferTracker<glm::mat4>>(cameraBuffer, viewProjection);
 
     device->ResizeEventSignal2.Register([this]()->void {
-        cameraBufferTracker->SetData(glm::identity<glm::mat4>());
+        cameraBufferTracker->SetData(viewProjection);
     });
 
-    linePipeline = std::make_shared<LinePipeline>(displayRenderPass, cameraBuffer, 10000);
+    linePipeline = std::make_shared<LinePipeline>(displayRenderPass, cameraBuffer, 10000, LinePipeline::Options{});
+    segmentPipeline = std::make_shared<LinePipeline>(
+        displayRenderPass,
+        cameraBuffer,
+        10000,
+        LinePipeline::Options{
+            .vertexColor = true,
+            .primitiveTopology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST
+        }
+    );
     pointPipeline = std::make_shared<PointPipeline>(displayRenderPass, cameraBuffer, 10000);
 
     pointRenderer = std::make_shared<PointRenderer>(pointPipeline);
+    lineRenderer = std::make_shared<LineRenderer>(segmentPipeline);
+
+    curveVertices = std::make_shared<VertexArena>();
+    lodVertices = std::make_shared<VertexArena>();
+
+    gpuEvaluator = Cinpact::GpuEvaluator::Create();
 
     device->SDL_EventSignal.Register([&](SDL_Event* event)->void
     {
@@ -96,6 +115,18 @@ void CinpactApp::Run()
         auto recordState = device->AcquireRecordState(swapChainResource->GetSwapChainImages().swapChain);
         if (recordState.isValid == true)
         {
+            // Submitted before the graphic commands, which wait for it before reading the vertices
+            if (gpuEvaluationPending == true)
+            {
+                device->BeginCommandBuffer(
+                    recordState,
+                    RT::CommandBufferType::Compute
+                );
+                gpuEvaluator->Evaluate(recordState, interpolate, cpFloatPositions, cpCConstants, cpKConstants, deltaU);
+                device->EndCommandBuffer(recordState);
+                gpuEvaluationPending = false;
+            }
+
             device->BeginCommandBuffer(
                 recordState,
                 RT::CommandBufferType::Graphic
@@ -103,42 +134,53 @@ void CinpactApp::Run()
 
             cameraBufferTracker->Update(recordState);
 
-            if (curveBufferNeedUpdate == true && curvePoints.empty() == false)
+            // Only the samples that changed since the last upload are copied, a shorter curve only updates the count
+            auto const dirtyRange = curve.DirtyRange();
+            auto const isCurveDirty = curve.IsDirty();
+            auto const curvePoints = curve.Samples();
+            if (isCurveDirty == true)
             {
-                curveBufferNeedUpdate = false;
-
-                auto const blob = MFA::Alias{ curvePoints.data(), curvePoints.size() };
-                
-                if (curveVertices == nullptr || curveVertices->size < blob.Len())
+                if (dirtyRange.begin < dirtyRange.end && curveVerticesDirtyBegin < curveVerticesDirtyEnd)
+                {
+                    curveVerticesDirtyBegin = std::min(curveVerticesDirtyBegin, dirtyRange.begin);
+                    curveVerticesDirtyEnd = std::max(curveVerticesDirtyEnd, dirtyRange.end);
+                }
+                else if (dirtyRange.begin < dirtyRange.end)
                 {
-                    stageBuffer = RB::CreateStageBuffer(
-                        LogicalDevice::Instance->GetVkDevice(),
-                        LogicalDevice::Instance->GetPhysicalDevice(),
-                        curvePoints.size() * sizeof(curvePoints[0]),
-                        1
-                    );
-                    curveVertices = RB::CreateVertexBuffer(
-                        LogicalDevice::Instance->GetVkDevice(),
-                        LogicalDevice::Instance->GetPhysicalDevice(),
-                        recordState.commandBuffer,
-                        *stageBuffer->buffers[0],
-                        blob
-                    );
+                    curveVerticesDirtyBegin = dirtyRange.begin;
+                    curveVerticesDirtyEnd = dirtyRange.end;
                 }
-                else
+                isCurveVerticesDirty = true;
+                if (curveLod.PointCount() == static_cast<int>(curvePoints.size()))
                 {
-                    RB::UpdateHostVisibleBuffer(
-                        LogicalDevice::Instance->GetVkDevice(),
-                        *stageBuffer->buffers[0],
-                        blob
-                    );
-                    RB::UpdateLocalBuffer(
-                        recordState.commandBuffer,
-                        *curveVertices,
-                        *stageBuffer->buffers[0]
-                    );
+                    curveLod.Update(curvePoints, dirtyRange.begin, dirtyRange.end);
                 }
+                curve.ClearDirtyRange();
+            }
+            // The dense vertices are only drawn without the LOD, until then their changes are collected
+            if (isCurveVerticesDirty == true && lod == false)
+            {
+                // The curve may have become shorter since the range was collected
+                auto const dirtyEnd = std::min(curveVerticesDirtyEnd, static_cast<int>(curvePoints.size()));
+                auto const dirtyBegin = std::min(curveVerticesDirtyBegin, dirtyEnd);
+                curveVertices->Update(
+                    recordState,
+                    MFA::Alias{ curvePoints.data(), curvePoints.size() },
+                    dirtyBegin * sizeof(curvePoints[0]),
+                    dirtyEnd * sizeof(curvePoints[0])
+                );
+                isCurveVerticesDirty = false;
+                curveVerticesDirtyBegin = 0;
+                curveVerticesDirtyEnd = 0;
+            }
+            // A different sample count shifts every sample after the first change, so the hierarchy is rebuilt. Checked
+            // on every frame rather than only for dirty samples, Select requires the hierarchy to match the samples
+            auto const isLodRebuilt = curveLod.PointCount() != static_cast<int>(curvePoints.size());
+            if (isLodRebuilt == true)
+            {
+                curveLod.Build(curvePoints);
             }
+            UpdateLod(recordState, isCurveDirty == true || isLodRebuilt == true);
 
             displayRenderPass->Begin(recordState);
 
@@ -167,10 +209,20 @@ void CinpactApp::Run()
 
 CinpactApp::~CinpactApp()
 {
-    stageBuffer.reset();
+    // The job writes into backCurve
+    CancelEvaluation();
+    if (evaluationJob.valid() == true)
+    {
+        evaluationJob.wait();
+    }
+
+    gpuEvaluator.reset();
+    lodVertices.reset();
     curveVertices.reset();
     pointRenderer.reset();
+    lineRenderer.reset();
     linePipeline.reset();
+    segmentPipeline.reset();
     pointPipeline.reset();
     cameraBufferTracker.reset();
 	cameraBuffer.reset();
@@ -180,6 +232,7 @@ CinpactApp::~CinpactApp()
     depthResource.reset();
     msaaResource.reset();
     device.reset();
+    jobSystem.reset();
     path.reset();
 }
 
@@ -187,31 +240,65 @@ CinpactApp::~CinpactApp()
 
 void CinpactApp::Update()
 {
-    if (mode == Mode::Move && leftMouseDown == true && selectedCP != nullptr)
+    PollEvaluation();
+
+    auto const selectedIdx = cpSlots.IndexOf(selectedCP);
+    auto const isDragging = mode == Mode::Move && leftMouseDown == true && selectedIdx >= 0;
+    if (isDragging == true)
     {
         int mx, my;
         SDL_GetMouseState(&mx, &my);
         auto const screen = device->GetSurfaceCapabilities().currentExtent;
         auto const mousePos = Math::ScreenSpaceToProjectedSpace({ mx, my }, screen.width, screen.height);
-        selectedCP->position = glm::vec3{ mousePos, DefaultZ };
-        curveChanged = true;
+        glm::vec3 const position{ mousePos, DefaultZ };
+
+        // The curve follows the cursor every frame, only a coarse subset of the affected samples is exact until Refine
+        if (cpFloatPositions[selectedIdx] != position)
+        {
+            pickGrid.Move(selectedCP, cpFloatPositions[selectedIdx], position);
+            cpPositions[selectedIdx] = position;
+            cpFloatPositions[selectedIdx] = position;
+            MarkColumnsDirty(selectedIdx, selectedIdx + 1);
+            if (UsesGpuEvaluation() == true)
+            {
+                curveChanged = true;
+            }
+            // Incremental updates need the shown curve to match the columns, which is not the case while an
+            // evaluation is pending. Its snapshot is outdated now as well
+            else if (curveChanged == false && IsEvaluating() == false)
+            {
+                curve.UpdateProgressive(selectedIdx, cpFloatPositions, cpCConstants, cpKConstants, CoarseStride);
+            }
+            else
+            {
+                CancelEvaluation();
+                curveChanged = true;
+            }
+        }
     }
-    else if (curveChanged == true)
+
+    // The gpu evaluates the whole curve within the frame that draws it, so there is nothing to refine
+    if (UsesGpuEvaluation() == true)
     {
+        gpuEvaluationPending |= curveChanged;
         curveChanged = false;
-        curveBufferNeedUpdate = true;
+        return;
+    }
 
-        std::vector<glm::vec3> controlPoints(cps.size());
-        std::vector<float> cConstants(cps.size());
-        std::vector<float> kConstants(cps.size());
-    	for (int i = 0; i < static_cast<int>(cps.size()); ++i)
-    	{
-            controlPoints[i] = cps[i].position;
-            kConstants[i] = cps[i].k;
-            cConstants[i] = cps[i].c;
-    	}
+    if (isDragging == false && curveChanged == true)
+    {
+        // Edits that arrive while a job runs are evaluated together once it is done
+        CancelEvaluation();
+        if (IsEvaluating() == false)
+        {
+            curveChanged = false;
+            StartEvaluation(nullptr);
+        }
+    }
 
-        curvePoints = Cinpact::Generate(interpolate, controlPoints, cConstants, kConstants, deltaU);
+    if (curveChanged == false && IsEvaluating() == false && curve.IsRefining() == true)
+    {
+        curve.Refine(cpFloatPositions, cpCConstants, cpKConstants, RefineBudget);
     }
 }
 
@@ -219,32 +306,50 @@ void CinpactApp::Update()
 
 void CinpactApp::Render(MFA::RT::CommandRecordState& recordState)
 {
-    for (auto const& cp : cps)
+    if (showControlPolygon == true)
     {
-        if (selectedCP != nullptr && selectedCP->idx == cp.idx)
+        for (int i = 1; i < static_cast<int>(cpFloatPositions.size()); ++i)
         {
-            pointRenderer->Draw(recordState, selectedCP->position, SelectedCP_Color);
+            lineRenderer->Add(cpFloatPositions[i - 1], cpFloatPositions[i], ControlPolygonColor);
         }
-        else if (cp.isOpenInTree == true)
+        lineRenderer->Draw(recordState);
+    }
+
+    auto const selectedIdx = cpSlots.IndexOf(selectedCP);
+    for (int i = 0; i < static_cast<int>(cpFloatPositions.size()); ++i)
+    {
+        if (i == selectedIdx)
         {
-            pointRenderer->Draw(recordState, cp.position, ActiveTreeCP_Color);
+            pointRenderer->Add(cpFloatPositions[i], SelectedCP_Color);
+        }
+        else if (cpInfos[i].isOpenInTree == true)
+        {
+            pointRenderer->Add(cpFloatPositions[i], ActiveTreeCP_Color);
         }
         else
         {
-            pointRenderer->Draw(recordState, cp.position, DefaultCP_Color);
+            pointRenderer->Add(cpFloatPositions[i], DefaultCP_Color);
         }
     }
+    pointRenderer->Draw(recordState);
+    LinePipeline::PushConstants const linePushConstants{
+        .model = glm::identity<glm::mat4>(),
+        .color = glm::vec4{0.0f, 1.0f, 1.0f, 1.0f}
+    };
+    if (UsesGpuEvaluation() == true)
+    {
+        linePipeline->BindPipeline(recordState);
+        linePipeline->SetPushConstants(recordState, linePushConstants);
+        gpuEvaluator->Draw(recordState);
+        return;
+    }
+    auto const curvePoints = lod == true ? std::span<glm::vec3 const>{ lodPoints } : curve.Samples();
+    auto const & vertices = lod == true ? lodVertices : curveVertices;
     if (curvePoints.empty() == false)
     {
         linePipeline->BindPipeline(recordState);
-        linePipeline->SetPushConstants(
-            recordState, 
-            LinePipeline::PushConstants{
-                .model = glm::identity<glm::mat4>(),
-                .color = glm::vec4{0.0f, 1.0f, 1.0f, 1.0f}
-			}
-        );
-        RB::BindVertexBuffer(recordState, *curveVertices);
+        linePipeline->SetPushConstants(recordState, linePushConstants);
+        RB::BindVertexBuffer(recordState, *vertices->Buffer());
         vkCmdDraw(
 			recordState.commandBuffer,
             curvePoints.size(),
@@ -268,6 +373,23 @@ void CinpactApp::OnUI()
         curveChanged = true;
     }
 
+    if (ImGui::Checkbox("Adaptive sampling", &adaptive))
+    {
+        curveChanged = true;
+    }
+
+    // The cpu curve is not kept up to date while the gpu evaluates
+    if (gpuEvaluator != nullptr && ImGui::Checkbox("GPU evaluation", &gpuEvaluation))
+    {
+        curveChanged = true;
+        gpuComparison.reset();
+    }
+    if (adaptive == true)
+    {
+        curveChanged |= ImGui::InputFloat("Max deviation", &adaptiveTolerance.maxDeviation);
+        curveChanged |= ImGui::InputFloat("Max angle", &adaptiveTolerance.maxAngle);
+    }
+
     if (ImGui::RadioButton("Add", mode == Mode::Add))
     {
         mode = Mode::Add;
@@ -295,7 +417,14 @@ void CinpactApp::OnUI()
 
     if (ImGui::Button("Remove all control points"))
     {
-        cps.clear();
+        cpPositions.clear();
+        cpFloatPositions.clear();
+        cpCConstants.clear();
+        cpKConstants.clear();
+        cpInfos.clear();
+        cpSlots.Clear();
+        pickGrid.Clear();
+        selectedCP = {};
         curveChanged = true;
     }
 
@@ -307,26 +436,116 @@ void CinpactApp::OnUI()
 
     ImGui::InputFloat("Default C", &defaultC);
 
-    if (selectedCP != nullptr && ImGui::TreeNode("Selected point: %s", selectedCP->name.c_str()))
+    auto const selectedIdx = cpSlots.IndexOf(selectedCP);
+    if (selectedIdx >= 0 && ImGui::TreeNode("Selected point: %s", cpInfos[selectedIdx].name.c_str()))
+    {
+        bool isChanged = ImGui::InputFloat("K", &cpKConstants[selectedIdx]);
+        isChanged |= ImGui::InputFloat("C", &cpCConstants[selectedIdx]);
+        if (isChanged == true)
+        {
+            MarkColumnsDirty(selectedIdx, selectedIdx + 1);
+            curveChanged = true;
+        }
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("File"))
+    {
+        ImGui::InputText("Path", curveFilePath, sizeof(curveFilePath));
+        if (ImGui::Button("Save"))
+        {
+            SaveCurve();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Load"))
+        {
+            LoadCurve();
+        }
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Precision benchmark"))
     {
-        curveChanged |= ImGui::InputFloat("K", &selectedCP->k);
-        curveChanged |= ImGui::InputFloat("C", &selectedCP->c);
+        if (ImGui::Button("Run") && cpPositions.empty() == false)
+        {
+            precisionBenchmark = Cinpact::BenchmarkPrecision(
+                interpolate, cpPositions, cpCConstants, cpKConstants, deltaU, 10
+            );
+        }
+        for (auto const & result : precisionBenchmark)
+        {
+            ImGui::Text(
+                "%s: %.3f ms, max error %.3g, mean error %.3g, validity mismatches %d",
+                result.name, result.milliseconds, result.maxError, result.meanError, result.validityMismatches
+            );
+        }
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Vertex upload"))
+    {
+        auto const & stats = curveVertices->GetStats();
+        ImGui::Text("Size: %.2f MB of %.2f MB", curveVertices->Size() / 1e6, curveVertices->Capacity() / 1e6);
+        ImGui::Text("Reallocations: %d", stats.reallocationCount);
+        ImGui::Text("Last upload: %.2f KB", stats.lastUploadSize / 1e3);
+        ImGui::Text("Total upload: %.2f MB", stats.totalUploadSize / 1e6);
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Control polygon"))
+    {
+        ImGui::Checkbox("Visible", &showControlPolygon);
+        auto const & stats = lineRenderer->GetStats();
+        ImGui::Text("Segments: %d", stats.segmentCount);
+        ImGui::Text("Streamed: %.2f KB", stats.streamedSize / 1e3);
+        ImGui::Text("Reallocations: %d", stats.reallocationCount);
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Level of detail"))
+    {
+        ImGui::Checkbox("Enabled", &lod);
+        ImGui::InputFloat("Pixel error", &lodPixelError);
+        lodPixelError = std::max(lodPixelError, 0.0f);
+        ImGui::Text("Vertices: %d of %d", static_cast<int>(lodPoints.size()), static_cast<int>(curve.Samples().size()));
+        ImGui::TreePop();
+    }
+    if (gpuEvaluator != nullptr && ImGui::TreeNode("GPU evaluation"))
+    {
+        ImGui::Text("Samples: %d", gpuEvaluator->SampleCount());
+        // Only meaningful once the evaluation of the current columns was submitted
+        auto const isUpToDate = UsesGpuEvaluation() == true && gpuEvaluationPending == false && curveChanged == false;
+        if (ImGui::Button("Compare with CPU") && isUpToDate == true)
+        {
+            gpuComparison = gpuEvaluator->CompareWithCpu(interpolate, cpFloatPositions, cpCConstants, cpKConstants, deltaU);
+        }
+        if (gpuComparison.has_value() == true)
+        {
+            ImGui::Text(
+                "%d samples, max error %.3g, validity mismatches %d, compaction mismatches %d",
+                gpuComparison->sampleCount,
+                gpuComparison->maxError,
+                gpuComparison->validityMismatches,
+                gpuComparison->compactionMismatches
+            );
+        }
         ImGui::TreePop();
     }
     if (ImGui::TreeNode("All points"))
     {
-        for (auto & cp : cps)
+        for (int i = 0; i < static_cast<int>(cpInfos.size()); ++i)
         {
-	        if (ImGui::TreeNode(cp.name.c_str()))
+            auto & info = cpInfos[i];
+	        if (ImGui::TreeNode(info.name.c_str()))
 	        {
-                curveChanged |= ImGui::InputFloat("K", &cp.k);
-                curveChanged |= ImGui::InputFloat("C", &cp.c);
+                bool isChanged = ImGui::InputFloat("K", &cpKConstants[i]);
+                isChanged |= ImGui::InputFloat("C", &cpCConstants[i]);
+                if (isChanged == true)
+                {
+                    MarkColumnsDirty(i, i + 1);
+                    curveChanged = true;
+                }
                 ImGui::TreePop();
-                cp.isOpenInTree = true;
+                info.isOpenInTree = true;
 	        }
 	        else
 	        {
-                cp.isOpenInTree = false;
+                info.isOpenInTree = false;
 	        }
         }
         ImGui::TreePop();
@@ -361,15 +580,19 @@ void CinpactApp::OnSDL_Event(SDL_Event* event)
             {
 	            case Mode::Add:
 		        {
-	                if (selectedCP == nullptr)
+	                if (cpSlots.IndexOf(selectedCP) < 0)
 	                {
-	                    auto& newControlPoint = cps.emplace_back();
+	                    auto& newControlPoint = cpInfos.emplace_back();
                         newControlPoint.idx = nextCpIdx++;
 	                    newControlPoint.name = "Point" + std::to_string(newControlPoint.idx);
-	                    newControlPoint.position = glm::vec3{ mousePos, DefaultZ };
-                        newControlPoint.c = defaultC;
-	                    newControlPoint.k = defaultK;
-	                    selectedCP = &newControlPoint;
+	                    selectedCP = cpSlots.Insert();
+	                    pickGrid.Insert(selectedCP, mousePos);
+	                    cpPositions.emplace_back(mousePos, DefaultZ);
+	                    cpFloatPositions.emplace_back(mousePos, DefaultZ);
+                        cpCConstants.emplace_back(defaultC);
+	                    cpKConstants.emplace_back(defaultK);
+                        auto const count = static_cast<int>(cpPositions.size());
+                        MarkColumnsDirty(count - 1, count);
                         curveChanged = true;
 	                }
 	            }
@@ -380,17 +603,19 @@ void CinpactApp::OnSDL_Event(SDL_Event* event)
 	                break;
 	            case Mode::Remove:
 	            {
-                    if (selectedCP != nullptr)
+                    auto const selectedIdx = cpSlots.IndexOf(selectedCP);
+                    if (selectedIdx >= 0)
                     {
-                        for (int i = static_cast<int>(cps.size() - 1); i >= 0; --i)
-                        {
-                            if (cps[i].idx == selectedCP->idx)
-                            {
-                                cps.erase(cps.begin() + i);
-                                break;
-                            }
-                        }
-                        selectedCP = nullptr;
+                        pickGrid.Remove(selectedCP, cpFloatPositions[selectedIdx]);
+                        cpSlots.Remove(selectedCP);
+                        cpPositions.erase(cpPositions.begin() + selectedIdx);
+                        cpFloatPositions.erase(cpFloatPositions.begin() + selectedIdx);
+                        cpCConstants.erase(cpCConstants.begin() + selectedIdx);
+                        cpKConstants.erase(cpKConstants.begin() + selectedIdx);
+                        cpInfos.erase(cpInfos.begin() + selectedIdx);
+                        // Every point after the removed one moved down by one
+                        MarkColumnsDirty(selectedIdx, static_cast<int>(cpPositions.size()));
+                        selectedCP = {};
                         curveChanged = true;
                     }
 	            }
@@ -420,21 +645,295 @@ void CinpactApp::OnSDL_Event(SDL_Event* event)
 
 //-----------------------------------------------------
 
-CinpactApp::ControlPointInfo* CinpactApp::GetClickedControlPoint(glm::vec2 const& mousePos)
+Cinpact::Handle CinpactApp::GetClickedControlPoint(glm::vec2 const& mousePos)
+{
+    return pickGrid.FindNearest(mousePos, PickRadius, cpSlots, cpFloatPositions);
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::SaveCurve()
+{
+    std::vector<std::string> names(cpInfos.size());
+    for (int i = 0; i < static_cast<int>(cpInfos.size()); ++i)
+    {
+        names[i] = cpInfos[i].name;
+    }
+
+    Cinpact::SaveCurveFile(curveFilePath, Cinpact::CurveFileContent{
+        .interpolate = interpolate,
+        .deltaU = deltaU,
+        .controlPoints = cpFloatPositions,
+        .cConstants = cpCConstants,
+        .kConstants = cpKConstants,
+        .names = names
+    });
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::LoadCurve()
+{
+    auto const curveFile = Cinpact::CurveFile::Load(curveFilePath);
+    if (curveFile == nullptr)
+    {
+        return;
+    }
+
+    interpolate = curveFile->Interpolate();
+    deltaU = curveFile->DeltaU();
+    selectedCP = {};
+
+    auto const controlPoints = curveFile->ControlPoints();
+    auto const cConstants = curveFile->CConstants();
+    auto const kConstants = curveFile->KConstants();
+
+    cpInfos.resize(controlPoints.size());
+    for (int i = 0; i < static_cast<int>(cpInfos.size()); ++i)
+    {
+        auto & info = cpInfos[i];
+        info.idx = nextCpIdx++;
+        info.name = curveFile->Name(i);
+        if (info.name.empty() == true)
+        {
+            info.name = "Point" + std::to_string(info.idx);
+        }
+        info.isOpenInTree = false;
+    }
+    cpPositions.assign(controlPoints.begin(), controlPoints.end());
+    cpFloatPositions.assign(controlPoints.begin(), controlPoints.end());
+    cpCConstants.assign(cConstants.begin(), cConstants.end());
+    cpKConstants.assign(kConstants.begin(), kConstants.end());
+    cpSlots.Reset(static_cast<int>(cpFloatPositions.size()));
+    pickGrid.Build(cpSlots, cpFloatPositions);
+    MarkColumnsDirty(0, static_cast<int>(cpFloatPositions.size()));
+
+    // The curve is evaluated straight from the mapped file, the copies above are only needed for editing. If an
+    // older evaluation is still running, the columns are evaluated once it is done. The gpu reads the columns
+    CancelEvaluation();
+    if (UsesGpuEvaluation() == true)
+    {
+        curveChanged = true;
+    }
+    else if (IsEvaluating() == false)
+    {
+        StartEvaluation(curveFile);
+        curveChanged = false;
+    }
+    else
+    {
+        curveChanged = true;
+    }
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::StartEvaluation(std::shared_ptr<Cinpact::CurveFile> curveFile)
+{
+    MFA_ASSERT(IsEvaluating() == false);
+
+    // Shared so that the job system does not copy the curve file handle along with the task
+    struct Input
+    {
+        bool interpolate = true;
+        bool adaptive = false;
+        Cinpact::AdaptiveTolerance tolerance{};
+        float deltaU = 0.0f;
+        std::shared_ptr<Cinpact::CurveFile> curveFile{};
+    };
+    auto input = std::make_shared<Input>();
+    input->interpolate = interpolate;
+    input->adaptive = adaptive;
+    input->tolerance = adaptiveTolerance;
+    input->deltaU = deltaU;
+    if (curveFile != nullptr)
+    {
+        input->curveFile = std::move(curveFile);
+    }
+    else
+    {
+        // No job reads the snapshot at this point, so it is brought up to date in place
+        auto const count = static_cast<int>(cpFloatPositions.size());
+        snapshotPositions.resize(count);
+        snapshotCConstants.resize(count);
+        snapshotKConstants.resize(count);
+        auto const begin = std::min(snapshotDirtyBegin, count);
+        auto const end = std::min(snapshotDirtyEnd, count);
+        if (begin < end)
+        {
+            auto const dirtyCount = end - begin;
+            std::copy_n(cpFloatPositions.begin() + begin, dirtyCount, snapshotPositions.begin() + begin);
+            std::copy_n(cpCConstants.begin() + begin, dirtyCount, snapshotCConstants.begin() + begin);
+            std::copy_n(cpKConstants.begin() + begin, dirtyCount, snapshotKConstants.begin() + begin);
+        }
+        snapshotDirtyBegin = 0;
+        snapshotDirtyEnd = 0;
+    }
+
+    auto isCancelled = std::make_shared<std::atomic<bool>>(false);
+    isEvaluationCancelled = isCancelled;
+
+    // Only the job touches backCurve until PollEvaluation sees that it is done
+    evaluationJob = jobSystem->AssignTask([this, input, isCancelled]()->void
+    {
+        if (isCancelled->load() == true)
+        {
+            return;
+        }
+
+        std::span<glm::vec3 const> controlPoints = snapshotPositions;
+        std::span<float const> cConstants = snapshotCConstants;
+        std::span<float const> kConstants = snapshotKConstants;
+        if (input->curveFile != nullptr)
+        {
+            controlPoints = input->curveFile->ControlPoints();
+            cConstants = input->curveFile->CConstants();
+            kConstants = input->curveFile->KConstants();
+        }
+
+        if (input->adaptive == true)
+        {
+            backCurve.EvaluateAdaptive(input->interpolate, controlPoints, cConstants, kConstants, input->tolerance);
+        }
+        else
+        {
+            backCurve.Evaluate(input->interpolate, controlPoints, cConstants, kConstants, input->deltaU);
+        }
+    });
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::MarkColumnsDirty(int const begin, int const end)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+    if (snapshotDirtyBegin >= snapshotDirtyEnd)
+    {
+        snapshotDirtyBegin = begin;
+        snapshotDirtyEnd = end;
+        return;
+    }
+    snapshotDirtyBegin = std::min(snapshotDirtyBegin, begin);
+    snapshotDirtyEnd = std::max(snapshotDirtyEnd, end);
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::PollEvaluation()
+{
+    if (IsEvaluating() == false || evaluationJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+    evaluationJob.get();
+
+    // Evaluate marks every sample as dirty, so the whole new curve is uploaded
+    if (isEvaluationCancelled->load() == false)
+    {
+        std::swap(curve, backCurve);
+    }
+    isEvaluationCancelled.reset();
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::CancelEvaluation()
 {
-    ControlPointInfo* selectedControlPoint = nullptr;
-    float selectedDistance = 0.0f;
-    for (auto& cp : cps)
+    if (isEvaluationCancelled != nullptr)
     {
-        auto const distance = glm::length2(glm::vec2{ cp.position } - mousePos);
-        if ((selectedControlPoint == nullptr && distance < 1e-3f) || distance < selectedDistance)
+        isEvaluationCancelled->store(true);
+    }
+}
+
+//-----------------------------------------------------
+
+bool CinpactApp::IsEvaluating() const
+{
+    return evaluationJob.valid();
+}
+
+//-----------------------------------------------------
+
+bool CinpactApp::UsesGpuEvaluation() const
+{
+    return gpuEvaluator != nullptr && gpuEvaluation == true && adaptive == false;
+}
+
+//-----------------------------------------------------
+
+float CinpactApp::LodTolerance() const
+{
+    // The camera is affine, so xy maps to pixels through the xy block of the camera followed by the viewport. That
+    // stretches any distance by at most the largest singular value of their product
+    auto const screen = device->GetSurfaceCapabilities().currentExtent;
+    glm::mat2 const viewport{ screen.width * 0.5f, 0.0f, 0.0f, screen.height * 0.5f };
+    auto const toPixels = viewport * glm::mat2{ viewProjection };
+
+    auto const frobeniusSquare = glm::dot(toPixels[0], toPixels[0]) + glm::dot(toPixels[1], toPixels[1]);
+    auto const determinant = toPixels[0][0] * toPixels[1][1] - toPixels[1][0] * toPixels[0][1];
+    auto const discriminant = std::max(frobeniusSquare * frobeniusSquare - 4.0f * determinant * determinant, 0.0f);
+    auto const largestStretch = std::sqrt(0.5f * (frobeniusSquare + std::sqrt(discriminant)));
+    if (largestStretch <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return lodPixelError / largestStretch;
+}
+
+//-----------------------------------------------------
+
+void CinpactApp::UpdateLod(RT::CommandRecordState const & recordState, bool const samplesChanged)
+{
+    if (samplesChanged == true)
+    {
+        lodSelectedTolerance = -1.0f;
+    }
+    if (lod == false)
+    {
+        return;
+    }
+
+    // Resizing the window or changing the pixel error selects a different cut of the same hierarchy
+    auto const tolerance = LodTolerance();
+    if (tolerance == lodSelectedTolerance)
+    {
+        return;
+    }
+    lodSelectedTolerance = tolerance;
+
+    // A new tolerance or a local edit often selects the same points, or changes only some of them. Only the points
+    // between the first and the last difference are uploaded, a different count shifts every point after the first one
+    curveLod.Select(curve.Samples(), tolerance, lodSelection);
+    auto const sharedCount = std::min(lodSelection.size(), lodPoints.size());
+    auto const dirtyBegin = static_cast<size_t>(std::mismatch(
+        lodSelection.begin(),
+        lodSelection.begin() + sharedCount,
+        lodPoints.begin()
+    ).first - lodSelection.begin());
+    auto dirtyEnd = lodSelection.size();
+    auto const isSameCount = lodSelection.size() == lodPoints.size();
+    if (isSameCount == true)
+    {
+        while (dirtyEnd > dirtyBegin && lodSelection[dirtyEnd - 1] == lodPoints[dirtyEnd - 1])
         {
-            selectedControlPoint = &cp;
-            selectedDistance = distance;
+            --dirtyEnd;
         }
     }
+    std::swap(lodPoints, lodSelection);
+    if (isSameCount == true && dirtyBegin == dirtyEnd)
+    {
+        return;
+    }
 
-    return selectedControlPoint;
+    lodVertices->Update(
+        recordState,
+        MFA::Alias{ lodPoints.data(), lodPoints.size() },
+        dirtyBegin * sizeof(lodPoints[0]),
+        dirtyEnd * sizeof(lodPoints[0])
+    );
 }
 
 //-----------------------------------------------------
@@ -1,7 +1,17 @@
 #pragma once
+#include <atomic>
+#include <future>
 #include <memory>
+#include <optional>
 
 #include "BedrockPath.hpp"
+#include "CinpactEvaluator.hpp"
+#include "CinpactFile.hpp"
+#include "CinpactGpuEvaluator.hpp"
+#include "CinpactLod.hpp"
+#include "CinpactPickGrid.hpp"
+#include "CinpactPrecision.hpp"
+#include "JobSystem.hpp"
 #include "BufferTracker.hpp"
 #include "LogicalDevice.hpp"
 #include "UI.hpp"
@@ -14,6 +24,7 @@
 #include "render_resource/SwapChainRenderResource.hpp"
 #include "utils/LineRenderer.hpp"
 #include "utils/PointRenderer.hpp"
+#include "utils/VertexArena.hpp"
 
 class CinpactApp
 {
@@ -27,13 +38,11 @@ public:
 
 private:
 
+	// Cold data of a control point, only the ui reads it
 	struct ControlPointInfo
 	{
 		int idx = 0;
 		std::string name{};
-		glm::dvec3 position{};
-		float k{};
-		float c{};
 
 		bool isOpenInTree = false;
 	};
@@ -54,7 +63,40 @@ private:
 
 	void OnSDL_Event(SDL_Event* event);
 
-	ControlPointInfo * GetClickedControlPoint(glm::vec2 const & mousePos);
+	// Returns an invalid handle if no control point is under the cursor
+	Cinpact::Handle GetClickedControlPoint(glm::vec2 const & mousePos);
+
+	// Evaluates a snapshot of the columns, or curveFile in place, into backCurve on the job system. No other
+	// evaluation may be running
+	void StartEvaluation(std::shared_ptr<Cinpact::CurveFile> curveFile);
+
+	// Control points [begin, end) of the columns changed, the next snapshot copies them again
+	void MarkColumnsDirty(int begin, int end);
+
+	// Swaps backCurve in once its evaluation is done, unless it was cancelled in the meantime
+	void PollEvaluation();
+
+	// The running evaluation can not be interrupted, its result is dropped instead
+	void CancelEvaluation();
+
+	[[nodiscard]]
+	bool IsEvaluating() const;
+
+	// Adaptive sampling has no gpu version
+	[[nodiscard]]
+	bool UsesGpuEvaluation() const;
+
+	// Distance in curve space that covers at most lodPixelError pixels on the surface
+	[[nodiscard]]
+	float LodTolerance() const;
+
+	// Selects the points of the curve that are drawn when the curve or the tolerance changed, only uploads the points that
+	// differ from the previous selection
+	void UpdateLod(MFA::RT::CommandRecordState const & recordState, bool samplesChanged);
+
+	void SaveCurve();
+
+	void LoadCurve();
 
 	// Render parameters
 	std::shared_ptr<MFA::Path> path{};
@@ -64,25 +106,51 @@ private:
 	std::shared_ptr<MFA::DepthRenderResource> depthResource{};
 	std::shared_ptr<MFA::MSSAA_RenderResource> msaaResource{};
 	std::shared_ptr<MFA::DisplayRenderPass> displayRenderPass{};
+	std::shared_ptr<MFA::JobSystem> jobSystem{};
 
+	// The curve is drawn in projected space
+	glm::mat4 const viewProjection = glm::identity<glm::mat4>();
 	std::shared_ptr<MFA::RT::BufferGroup> cameraBuffer{};
 	std::shared_ptr<MFA::HostVisibleBufferTracker<glm::mat4>> cameraBufferTracker{};
 
 	std::shared_ptr<MFA::LinePipeline> linePipeline{};
+	// Line list with a color per vertex, lineRenderer draws the control polygon with it
+	std::shared_ptr<MFA::LinePipeline> segmentPipeline{};
+	std::shared_ptr<MFA::LineRenderer> lineRenderer{};
 	
 	std::shared_ptr<MFA::PointPipeline> pointPipeline{};
 	std::shared_ptr<MFA::PointRenderer> pointRenderer{};
 	
-	std::vector<ControlPointInfo> cps{};		// Control points
-
-	ControlPointInfo* selectedCP{};
+	// Control points are stored as columns that are passed to the evaluator as they are, item i of each column
+	// belongs to the same control point. Positions are kept in double for the precision benchmark, cpFloatPositions
+	// is the float copy that the evaluators, the renderers and the pick grid read. Both are edited together
+	std::vector<glm::dvec3> cpPositions{};
+	std::vector<glm::vec3> cpFloatPositions{};
+	std::vector<float> cpCConstants{};
+	std::vector<float> cpKConstants{};
+	std::vector<ControlPointInfo> cpInfos{};
+	// Stable handles to the items of the columns, the ui and the pick grid refer to control points by handle
+	Cinpact::SlotMap cpSlots{};
+
+	// sqrt(1e-3) in projected space, points are picked within this distance of the cursor
+	static constexpr float PickRadius = 0.0316227766f;
+	// Has to be kept in sync with cpFloatPositions
+	Cinpact::PickGrid pickGrid{PickRadius};
+
+	// Stays selected while other points are added or removed, becomes invalid once the point itself is removed
+	Cinpact::Handle selectedCP{};
 	
 	const glm::vec4 DefaultCP_Color{ 1.0, 0.0, 0.0, 1.0 };
 	const glm::vec4 ActiveTreeCP_Color{ 1.0, 1.0, 0.0, 1.0 };
 	const glm::vec4 SelectedCP_Color{ 0.0, 1.0, 0.0, 1.0 };
+	const glm::vec4 ControlPolygonColor{ 0.5, 0.5, 0.5, 1.0 };
+
+	bool showControlPolygon = false;
 
 	bool interpolate = true;
 	float deltaU = 1e-2f;
+	bool adaptive = false;
+	Cinpact::AdaptiveTolerance adaptiveTolerance{};
 	float defaultK = 10.0f;
 	float defaultC = 10.0f;
 
@@ -92,10 +160,43 @@ private:
 
 	int nextCpIdx = 0;
 
-	bool curveChanged = false;
-	std::vector<glm::vec3> curvePoints{};
-	bool curveBufferNeedUpdate = false;
-	std::shared_ptr<MFA::RT::BufferAndMemory> curveVertices{};
-	std::shared_ptr<MFA::RT::BufferGroup> stageBuffer{};
+	bool curveChanged = false;			// The whole curve needs to be evaluated again
+	// The frame keeps drawing curve while a job evaluates backCurve, they are swapped when the job is done
+	Cinpact::Evaluator curve{};
+	Cinpact::Evaluator backCurve{};
+	std::future<void> evaluationJob{};
+	std::shared_ptr<std::atomic<bool>> isEvaluationCancelled{};
+	// Copy of the columns that the evaluation job reads. StartEvaluation only updates it while no job runs and only
+	// copies the control points that changed since the last snapshot
+	std::vector<glm::vec3> snapshotPositions{};
+	std::vector<float> snapshotCConstants{};
+	std::vector<float> snapshotKConstants{};
+	int snapshotDirtyBegin = 0;
+	int snapshotDirtyEnd = 0;
+	std::shared_ptr<MFA::VertexArena> curveVertices{};
+	// Samples that changed since the last upload to curveVertices, which waits while the LOD is drawn instead
+	bool isCurveVerticesDirty = false;
+	int curveVerticesDirtyBegin = 0;
+	int curveVerticesDirtyEnd = 0;
+
+	// Dense samples are drawn through a simplification of the polyline, so the vertex count follows the surface size
+	// rather than deltaU
+	bool lod = true;
+	float lodPixelError = 0.5f;
+	Cinpact::PolylineLod curveLod{};
+	std::vector<glm::vec3> lodPoints{};
+	std::vector<glm::vec3> lodSelection{};		// Next selection, it is compared with lodPoints before the upload
+	std::shared_ptr<MFA::VertexArena> lodVertices{};
+	float lodSelectedTolerance = -1.0f;		// Tolerance of lodPoints, negative when they need to be selected again
+
+	// Null when the compute shader is not available
+	std::shared_ptr<Cinpact::GpuEvaluator> gpuEvaluator{};
+	bool gpuEvaluation = false;
+	bool gpuEvaluationPending = false;		// Recorded on the compute command buffer of the next frame
+	std::optional<Cinpact::GpuEvaluator::Comparison> gpuComparison{};
+
+	std::vector<Cinpact::PrecisionBenchmarkResult> precisionBenchmark{};
+
+	char curveFilePath[256] = "curve.cpb";
 	
 };
@@ -0,0 +1,135 @@
+#include "CinpactArcLength.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <geometric.hpp>
+
+#include <algorithm>
+#include <bit>
+
+//-----------------------------------------------------
+
+void Cinpact::ArcLengthTable::Build(std::span<glm::vec3 const> const points)
+{
+	auto const segmentCount = std::max(0, static_cast<int>(points.size()) - 1);
+	_segmentLengths.resize(segmentCount);
+	_tree.assign(segmentCount + 1, 0.0);
+	_highestBit = segmentCount > 0 ? static_cast<int>(std::bit_floor(static_cast<unsigned>(segmentCount))) : 0;
+
+	// Linear time construction, each node passes its sum on to its parent
+	for (int j = 0; j < segmentCount; ++j)
+	{
+		_segmentLengths[j] = glm::distance(points[j], points[j + 1]);
+		_tree[j + 1] += _segmentLengths[j];
+		auto const parent = (j + 1) + ((j + 1) & -(j + 1));
+		if (parent <= segmentCount)
+		{
+			_tree[parent] += _tree[j + 1];
+		}
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::ArcLengthTable::Update(std::span<glm::vec3 const> const points, int const first, int const last)
+{
+	MFA_ASSERT(static_cast<int>(points.size()) == PointCount());
+
+	// A moved point changes the segments on both sides of it
+	auto const firstSegment = std::max(0, first - 1);
+	auto const lastSegment = std::min(static_cast<int>(_segmentLengths.size()), last);
+	for (int j = firstSegment; j < lastSegment; ++j)
+	{
+		SetSegment(j, glm::distance(points[j], points[j + 1]));
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::ArcLengthTable::Clear()
+{
+	_segmentLengths.clear();
+	_tree.clear();
+	_highestBit = 0;
+}
+
+//-----------------------------------------------------
+
+int Cinpact::ArcLengthTable::PointCount() const
+{
+	return _tree.empty() == true ? 0 : static_cast<int>(_segmentLengths.size()) + 1;
+}
+
+//-----------------------------------------------------
+
+float Cinpact::ArcLengthTable::Length() const
+{
+	return static_cast<float>(PrefixLength(static_cast<int>(_segmentLengths.size())));
+}
+
+//-----------------------------------------------------
+
+float Cinpact::ArcLengthTable::DistanceAt(int const pointIdx) const
+{
+	MFA_ASSERT(pointIdx >= 0 && pointIdx < std::max(1, PointCount()));
+	return static_cast<float>(PrefixLength(pointIdx));
+}
+
+//-----------------------------------------------------
+
+float Cinpact::ArcLengthTable::PointAtDistance(float const distance) const
+{
+	auto const segmentCount = static_cast<int>(_segmentLengths.size());
+	if (segmentCount == 0 || distance <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// Binary lifting finds the number of whole segments whose total length does not exceed distance
+	double remaining = distance;
+	int segmentIdx = 0;
+	for (int step = _highestBit; step > 0; step >>= 1)
+	{
+		auto const next = segmentIdx + step;
+		if (next <= segmentCount && _tree[next] <= remaining)
+		{
+			segmentIdx = next;
+			remaining -= _tree[next];
+		}
+	}
+
+	if (segmentIdx >= segmentCount)
+	{
+		return static_cast<float>(segmentCount);
+	}
+	auto const segmentLength = _segmentLengths[segmentIdx];
+	auto const t = segmentLength > 0.0 ? std::min(1.0, remaining / segmentLength) : 0.0;
+	return static_cast<float>(segmentIdx + t);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::ArcLengthTable::SetSegment(int const segmentIdx, double const length)
+{
+	auto const delta = length - _segmentLengths[segmentIdx];
+	_segmentLengths[segmentIdx] = length;
+	auto const size = static_cast<int>(_segmentLengths.size());
+	for (int node = segmentIdx + 1; node <= size; node += node & -node)
+	{
+		_tree[node] += delta;
+	}
+}
+
+//-----------------------------------------------------
+
+double Cinpact::ArcLengthTable::PrefixLength(int const segmentCount) const
+{
+	double length = 0.0;
+	for (int node = segmentCount; node > 0; node -= node & -node)
+	{
+		length += _tree[node];
+	}
+	return length;
+}
+
+//-----------------------------------------------------
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vec3.hpp>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Cumulative length of a polyline. Segment lengths are kept in a Fenwick tree, so moving some of the points and
+	// mapping a distance back to a position along the polyline are both O(log n)
+	class ArcLengthTable
+	{
+	public:
+
+		void Build(std::span<glm::vec3 const> points);
+
+		// Points [first, last) moved, the number of points must be the same as in the last Build call
+		void Update(std::span<glm::vec3 const> points, int first, int last);
+
+		void Clear();
+
+		[[nodiscard]]
+		int PointCount() const;
+
+		[[nodiscard]]
+		float Length() const;
+
+		// Length of the polyline from the first point to point pointIdx
+		[[nodiscard]]
+		float DistanceAt(int pointIdx) const;
+
+		// Fractional point index at distance from the first point, clamped to [0, PointCount() - 1]
+		[[nodiscard]]
+		float PointAtDistance(float distance) const;
+
+	private:
+
+		void SetSegment(int segmentIdx, double length);
+
+		// Sum of the lengths of segments [0, segmentCount)
+		[[nodiscard]]
+		double PrefixLength(int segmentCount) const;
+
+		std::vector<double> _segmentLengths{};
+		// 1-based Fenwick tree over _segmentLengths
+		std::vector<double> _tree{};
+		int _highestBit = 0;
+	};
+}
@@ -3,8 +3,303 @@
 #include "BedrockAssert.hpp"
 
 #include <ext/scalar_constants.hpp>
+#include <geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define USE_OMP
+#define USE_COMPACT_SUPPORT
+#define USE_SIMD
+#define USE_BASIS_TABLE
+
+// Number of weights that are computed per CalcWeights call
+static constexpr int WeightChunkSize = 64;
+// Larger supports fall back to computing the weights
+static constexpr int MaxBasisTableSize = 1 << 20;
+// Number of samples per work item of GenerateBatch
+static constexpr int BatchChunkSize = 1024;
+// Every span starts as this many segments so that a feature between two tested points is not missed
+static constexpr int AdaptiveInitialSegments = 4;
+
+//-----------------------------------------------------
+
+// CalcA is zero whenever |u - i| > c, so only the control points inside the widest support can contribute to a sample
+static float MaxSupport(std::span<float const> const & cConstants)
+{
+	float maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		maxC = std::max(maxC, c);
+	}
+	return maxC;
+}
+
+//-----------------------------------------------------
+
+static void SupportWindow(
+	float const u,
+	float const maxC,
+	int const controlPointCount,
+	int & outFirst,
+	int & outLast
+)
+{
+	auto const lastIdx = static_cast<float>(controlPointCount - 1);
+	outFirst = static_cast<int>(std::ceil(std::clamp(u - maxC, 0.0f, lastIdx)));
+	outLast = static_cast<int>(std::floor(std::clamp(u + maxC, 0.0f, lastIdx)));
+}
+
+//-----------------------------------------------------
+
+// Per thread scratch memory, it persists between calls so steady state evaluations do not allocate
+static thread_local std::vector<float> weightsScratch{};
+static thread_local std::vector<glm::vec3> samplesScratch{};
+static thread_local std::vector<glm::vec3> firstDerivativesScratch{};
+static thread_local std::vector<glm::vec3> secondDerivativesScratch{};
+static thread_local std::vector<uint8_t> isValidScratch{};
+static thread_local std::vector<int> blockOffsetsScratch{};
+
+struct BatchWorkItem
+{
+	int curve;
+	int firstSample;
+	int lastSample;
+};
+static thread_local std::vector<BatchWorkItem> workItemsScratch{};
+static thread_local std::vector<float> maxSupportScratch{};
+static thread_local std::vector<uint8_t> usesBasisTableScratch{};
+
+struct AdaptiveSegment
+{
+	float beginU;
+	float endU;
+	glm::vec3 begin;
+	glm::vec3 end;
+	bool isBeginValid;
+	bool isEndValid;
+	// The quarter points of a split segment are the middles of its halves, the initial segments evaluate theirs
+	bool hasMiddle;
+	glm::vec3 middle;
+	bool isMiddleValid;
+};
+static thread_local std::vector<AdaptiveSegment> segmentStackScratch{};
+static thread_local std::vector<std::vector<glm::vec3>> spanSamplesScratch{};
+static thread_local std::vector<std::vector<float>> spanParametersScratch{};
+
+//-----------------------------------------------------
+
+// When every control point shares c and k and there are samplesPerUnit samples between two control points, u - i is
+// always a whole number of samples, so each weight is one of the 2 * radius + 1 entries of the table
+struct BasisTable
+{
+	bool interpolate = false;
+	float c = 0.0f;
+	float k = 0.0f;
+	float deltaU = 0.0f;
+
+	int samplesPerUnit = 0;
+	int radius = 0;
+	// Weight of the control point that is d samples away at index radius + d
+	std::vector<float> weights{};
+};
+
+static thread_local BasisTable basisTableCache{};
+
+//-----------------------------------------------------
+
+// Returns 0 if 1 / deltaU is not a whole number
+static int SamplesPerUnit(float const deltaU)
+{
+	if (deltaU <= 0.0f || deltaU > 1.0f)
+	{
+		return 0;
+	}
+	auto const samplesPerUnit = std::round(1.0f / deltaU);
+	if (std::abs(samplesPerUnit * deltaU - 1.0f) > 1e-5f)
+	{
+		return 0;
+	}
+	return static_cast<int>(samplesPerUnit);
+}
+
+//-----------------------------------------------------
+
+// The table is cached per thread and rebuilt only when one of interpolate, c, k or deltaU changes
+static BasisTable const * GetBasisTable(bool const interpolate, float const c, float const k, float const deltaU)
+{
+	auto & table = basisTableCache;
+	if (table.weights.empty() == false && table.interpolate == interpolate && table.c == c && table.k == k && table.deltaU == deltaU)
+	{
+		return &table;
+	}
+
+	table.interpolate = interpolate;
+	table.c = c;
+	table.k = k;
+	table.deltaU = deltaU;
+	table.samplesPerUnit = SamplesPerUnit(deltaU);
+	table.radius = static_cast<int>(std::floor(std::max(c, 0.0f) * static_cast<float>(table.samplesPerUnit)));
+	table.weights.resize(2 * table.radius + 1);
+	for (int d = -table.radius; d <= table.radius; ++d)
+	{
+		auto const uMinI = static_cast<float>(d) / static_cast<float>(table.samplesPerUnit);
+		auto weight = Cinpact::CalcA(uMinI, 0.0f, c, k);
+		if (interpolate == true)
+		{
+			// On whole offsets sin(pi * x) / (pi * x) is exactly 1 at zero and 0 elsewhere, CalcI only gets close
+			if (d % table.samplesPerUnit == 0)
+			{
+				weight *= d == 0 ? 1.0f : 0.0f;
+			}
+			else
+			{
+				weight *= Cinpact::CalcI(uMinI, 0.0f);
+			}
+		}
+		table.weights[table.radius + d] = weight;
+	}
+
+	return &table;
+}
+
+//-----------------------------------------------------
+
+// Returns nullptr when the curve can not be evaluated from a table
+static BasisTable const * FindBasisTable(
+	bool const interpolate,
+	std::span<float const> const & cConstants,
+	std::span<float const> const & kConstants,
+	float const deltaU,
+	Cinpact::BasisTableMode const mode = Cinpact::BasisTableMode::Detect
+)
+{
+	if (mode == Cinpact::BasisTableMode::Compute)
+	{
+		return nullptr;
+	}
+	if (mode == Cinpact::BasisTableMode::Detect && Cinpact::UsesBasisTable(cConstants, kConstants, deltaU) == false)
+	{
+		return nullptr;
+	}
+	MFA_ASSERT(cConstants.empty() == false);
+	return GetBasisTable(interpolate, cConstants.front(), kConstants.front(), deltaU);
+}
+
+//-----------------------------------------------------
+
+// Returns the sum of weights at u, outValue is the weighted sum of the control points
+static float EvaluateAt(
+	bool const interpolate,
+	float const u,
+	std::span<glm::vec3 const> const & controlPoints,
+	std::span<float const> const & cConstants,
+	std::span<float const> const & kConstants,
+	float const maxC,
+	glm::vec3 & outValue
+)
+{
+	float weightSum = 0.0f;
+	outValue = {};
+
+#ifdef USE_COMPACT_SUPPORT
+	int first, last;
+	SupportWindow(u, maxC, static_cast<int>(controlPoints.size()), first, last);
+
+#ifdef USE_SIMD
+	float weights[WeightChunkSize];
+	for (int chunk = first; chunk <= last; chunk += WeightChunkSize)
+	{
+		auto const count = std::min(WeightChunkSize, last - chunk + 1);
+		Cinpact::CalcWeights(interpolate, u, chunk, count, cConstants.data(), kConstants.data(), weights);
+		for (int j = 0; j < count; ++j)
+		{
+			outValue += weights[j] * controlPoints[chunk + j];
+			weightSum += weights[j];
+		}
+	}
+#else
+	for (int i = first; i <= last; ++i)
+	{
+		auto weight = Cinpact::CalcA(u, static_cast<float>(i), cConstants[i], kConstants[i]);
+		if (interpolate == true)
+		{
+			weight *= Cinpact::CalcI(u, static_cast<float>(i));
+		}
+		outValue += weight * controlPoints[i];
+		weightSum += weight;
+	}
+#endif
+
+#else
+	auto & weights = weightsScratch;
+	weights.resize(controlPoints.size());
+	for (int i = 0; i < static_cast<int>(weights.size()); ++i)
+	{
+		weights[i] = Cinpact::CalcA(u, static_cast<float>(i), cConstants[i], kConstants[i]);
+		if (interpolate == true)
+		{
+			weights[i] *= Cinpact::CalcI(u, static_cast<float>(i));
+		}
+		weightSum += weights[i];
+	}
+
+	if (weightSum != 0.0f)
+	{
+		for (int i = 0; i < static_cast<int>(controlPoints.size()); ++i)
+		{
+			outValue += weights[i] * controlPoints[i];
+		}
+	}
+#endif
+
+	return weightSum;
+}
+
+//-----------------------------------------------------
+
+// Same as EvaluateAt for u = (sampleIdx + 1) * deltaU, reads the weights from basisTable if there is one
+static float EvaluateSample(
+	bool const interpolate,
+	int const sampleIdx,
+	float const deltaU,
+	std::span<glm::vec3 const> const & controlPoints,
+	std::span<float const> const & cConstants,
+	std::span<float const> const & kConstants,
+	float const maxC,
+	BasisTable const * basisTable,
+	glm::vec3 & outValue
+)
+{
+	if (basisTable != nullptr)
+	{
+		float weightSum = 0.0f;
+		outValue = {};
+
+		// Control point i is sampleIdx + 1 - i * samplesPerUnit samples away
+		auto const s = sampleIdx + 1;
+		auto const m = basisTable->samplesPerUnit;
+		auto const r = basisTable->radius;
+		auto const first = s - r <= 0 ? 0 : (s - r + m - 1) / m;
+		auto const last = std::min(static_cast<int>(controlPoints.size()) - 1, (s + r) / m);
+		auto const * weights = basisTable->weights.data() + r + s;
+		for (int i = first; i <= last; ++i)
+		{
+			auto const weight = weights[-i * m];
+			outValue += weight * controlPoints[i];
+			weightSum += weight;
+		}
+		return weightSum;
+	}
+
+	auto const u = (sampleIdx * deltaU) + deltaU;
+	return EvaluateAt(interpolate, u, controlPoints, cConstants, kConstants, maxC, outValue);
+}
 
 //-----------------------------------------------------
 
@@ -16,84 +311,845 @@ std::vector<glm::vec3> Cinpact::Generate(
 	float const deltaU
 )
 {
-	std::vector<glm::vec3> result{};
+	std::vector<glm::vec3> result(SampleCount(static_cast<int>(controlPoints.size()), deltaU));
+	auto const validCount = Generate(interpolate, controlPoints, cConstants, kConstants, deltaU, result);
+	result.resize(validCount);
+	return result;
+}
+
+//-----------------------------------------------------
+
+int Cinpact::Generate(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	std::span<glm::vec3> const output
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+
+	auto const stepCount = SampleCount(static_cast<int>(controlPoints.size()), deltaU);
+	MFA_ASSERT(static_cast<int>(output.size()) >= stepCount);
+
+	auto const maxC = MaxSupport(cConstants);
+	auto const * basisTable = FindBasisTable(interpolate, cConstants, kConstants, deltaU);
+
+	// Samples are evaluated into scratch memory and then compacted into output with a prefix sum over the per thread
+	// valid counts. Each thread compacts its own contiguous block, so the output keeps the order of u.
+	auto & samples = samplesScratch;
+	samples.resize(stepCount);
+	auto & isValid = isValidScratch;
+	isValid.resize(stepCount);
+	auto & blockOffsets = blockOffsetsScratch;
 
 #ifdef USE_OMP
+	#pragma omp parallel
+#endif
+	{
+#if defined(USE_OMP) && defined(_OPENMP)
+		auto const threadCount = omp_get_num_threads();
+		auto const threadIdx = omp_get_thread_num();
+#else
+		int const threadCount = 1;
+		int const threadIdx = 0;
+#endif
 
-	float stepCountF = static_cast<float>(controlPoints.size()) - 1.0f - 2.0f * deltaU;
-	stepCountF /= deltaU;
-	auto stepCount = static_cast<int>(std::ceil(stepCountF));
-	stepCount = std::max(0, stepCount);
+		#pragma omp single
+		{
+			blockOffsets.assign(threadCount + 1, 0);
+		}
+
+		auto const blockBegin = static_cast<int>((static_cast<int64_t>(stepCount) * threadIdx) / threadCount);
+		auto const blockEnd = static_cast<int>((static_cast<int64_t>(stepCount) * (threadIdx + 1)) / threadCount);
+
+		int blockValidCount = 0;
+		for (int k = blockBegin; k < blockEnd; ++k)
+		{
+			glm::vec3 value;
+			auto const weightSum = EvaluateSample(
+				interpolate, k, deltaU, controlPoints, cConstants, kConstants, maxC, basisTable, value
+			);
+
+			samples[k] = weightSum != 0.0f ? value / weightSum : value;
+			isValid[k] = weightSum > 0.0f;
+			blockValidCount += isValid[k];
+		}
+		blockOffsets[threadIdx + 1] = blockValidCount;
+
+		#pragma omp barrier
+
+		#pragma omp single
+		{
+			for (int i = 0; i < threadCount; ++i)
+			{
+				blockOffsets[i + 1] += blockOffsets[i];
+			}
+		}
+
+		auto outIdx = blockOffsets[threadIdx];
+		for (int k = blockBegin; k < blockEnd; ++k)
+		{
+			if (isValid[k] != 0)
+			{
+				output[outIdx++] = samples[k];
+			}
+		}
+	}
+
+	auto const validCount = blockOffsets.back();
+
+	return validCount;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateRange(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	int const firstSample,
+	int const lastSample,
+	std::span<glm::vec3> const outSamples,
+	std::span<uint8_t> const outIsValid,
+	float const maxC,
+	BasisTableMode const basisTableMode
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(firstSample >= 0 && lastSample <= static_cast<int>(outSamples.size()));
+	MFA_ASSERT(outIsValid.size() == outSamples.size());
+
+	auto const * basisTable = FindBasisTable(interpolate, cConstants, kConstants, deltaU, basisTableMode);
+
+#ifdef USE_OMP
+	#pragma omp parallel for
+#endif
+	for (int k = firstSample; k < lastSample; ++k)
+	{
+		glm::vec3 value;
+		auto const weightSum = EvaluateSample(
+			interpolate, k, deltaU, controlPoints, cConstants, kConstants, maxC, basisTable, value
+		);
+
+		outSamples[k] = weightSum != 0.0f ? value / weightSum : value;
+		outIsValid[k] = weightSum > 0.0f;
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateSamples(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	std::span<int const> const sampleIndices,
+	std::span<glm::vec3> const outSamples,
+	std::span<uint8_t> const outIsValid,
+	float const maxC,
+	BasisTableMode const basisTableMode
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(outIsValid.size() == outSamples.size());
 
-	result.resize(stepCount);
-	std::vector<bool> isValid(stepCount);
+	auto const * basisTable = FindBasisTable(interpolate, cConstants, kConstants, deltaU, basisTableMode);
+	auto const indexCount = static_cast<int>(sampleIndices.size());
 
+#ifdef USE_OMP
 	#pragma omp parallel for
-	for (int k = 0; k < result.size(); ++k)
+#endif
+	for (int j = 0; j < indexCount; ++j)
+	{
+		auto const k = sampleIndices[j];
+
+		glm::vec3 value;
+		auto const weightSum = EvaluateSample(
+			interpolate, k, deltaU, controlPoints, cConstants, kConstants, maxC, basisTable, value
+		);
+
+		outSamples[k] = weightSum != 0.0f ? value / weightSum : value;
+		outIsValid[k] = weightSum > 0.0f;
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateWindow(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	int64_t const firstPoint,
+	int64_t const firstSample,
+	std::span<glm::vec3> const outSamples,
+	std::span<uint8_t> const outIsValid
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(outIsValid.size() == outSamples.size());
+	MFA_ASSERT(firstPoint >= 0 && firstSample >= 0);
+
+	auto const maxC = MaxSupport(cConstants);
+	auto const * basisTable = FindBasisTable(interpolate, cConstants, kConstants, deltaU);
+	auto const sampleCount = static_cast<int>(outSamples.size());
+
+	// With a table the weights only depend on the offset in samples, so shifting the grid by firstPoint control points
+	// gives the same weights as evaluating the whole curve
+	int64_t windowFirstSample = 0;
+	if (basisTable != nullptr)
+	{
+		windowFirstSample = firstSample - firstPoint * basisTable->samplesPerUnit;
+		MFA_ASSERT(windowFirstSample + 1 >= 0);
+	}
+
+#ifdef USE_OMP
+	#pragma omp parallel for
+#endif
+	for (int j = 0; j < sampleCount; ++j)
+	{
+		glm::vec3 value;
+		float weightSum;
+		if (basisTable != nullptr)
+		{
+			weightSum = EvaluateSample(
+				interpolate,
+				static_cast<int>(windowFirstSample + j),
+				deltaU,
+				controlPoints,
+				cConstants,
+				kConstants,
+				maxC,
+				basisTable,
+				value
+			);
+		}
+		else
+		{
+			auto const u = static_cast<double>(firstSample + j + 1) * deltaU - static_cast<double>(firstPoint);
+			weightSum = EvaluateAt(interpolate, static_cast<float>(u), controlPoints, cConstants, kConstants, maxC, value);
+		}
+
+		outSamples[j] = weightSum != 0.0f ? value / weightSum : value;
+		outIsValid[j] = weightSum > 0.0f;
+	}
+}
+
+//-----------------------------------------------------
+
+// Weight w = A * I of a control point at offset x = u - i with its first and second derivative.
+// A = exp(g) with g = -k x^2 / (c^2 - x^2), so A' = A g' and A'' = A (g'' + g'^2).
+// I = sin(pi x) / (pi x), so I' = (cos(pi x) - I) / x and I'' = -pi^2 I - 2 I' / x.
+static void CalcWeightDerivatives(
+	bool const interpolate,
+	float const x,
+	float const c,
+	float const k,
+	float & outWeight,
+	float & outFirstDerivative,
+	float & outSecondDerivative
+)
+{
+	outWeight = 0.0f;
+	outFirstDerivative = 0.0f;
+	outSecondDerivative = 0.0f;
+	if (x < -c || x > c)
+	{
+		return;
+	}
+
+	auto const xSquare = x * x;
+	auto const cSquare = c * c;
+	auto bottom = cSquare - xSquare;
+	if (bottom == 0.0f)
+	{
+		bottom += glm::epsilon<float>();
+	}
+
+	auto const a = std::exp(-k * xSquare / bottom);
+	// Also avoids 0 * inf at the edge of the support
+	if (a == 0.0f)
+	{
+		return;
+	}
+	auto const g1 = -2.0f * k * cSquare * x / (bottom * bottom);
+	auto const g2 = -2.0f * k * cSquare * (cSquare + 3.0f * xSquare) / (bottom * bottom * bottom);
+	auto const a1 = a * g1;
+	auto const a2 = a * (g2 + g1 * g1);
+
+	if (interpolate == false)
+	{
+		outWeight = a;
+		outFirstDerivative = a1;
+		outSecondDerivative = a2;
+		return;
+	}
+
+	auto const piX = glm::pi<float>() * x;
+	float i0, i1, i2;
+	if (std::abs(x) < 1e-3f)
+	{
+		// Taylor expansion, the closed forms divide by x
+		auto const piSquare = glm::pi<float>() * glm::pi<float>();
+		i0 = 1.0f - piX * piX / 6.0f;
+		i1 = -piSquare * x / 3.0f;
+		i2 = -piSquare / 3.0f;
+	}
+	else
+	{
+		i0 = std::sin(piX) / piX;
+		i1 = (std::cos(piX) - i0) / x;
+		i2 = -glm::pi<float>() * glm::pi<float>() * i0 - 2.0f * i1 / x;
+	}
+
+	outWeight = a * i0;
+	outFirstDerivative = a1 * i0 + a * i1;
+	outSecondDerivative = a2 * i0 + 2.0f * a1 * i1 + a * i2;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateRange(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	int const firstSample,
+	int const lastSample,
+	std::span<glm::vec3> const outSamples,
+	std::span<glm::vec3> const outFirstDerivatives,
+	std::span<glm::vec3> const outSecondDerivatives,
+	std::span<uint8_t> const outIsValid
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(firstSample >= 0 && lastSample <= static_cast<int>(outSamples.size()));
+	MFA_ASSERT(outIsValid.size() == outSamples.size());
+	MFA_ASSERT(outFirstDerivatives.empty() == true || outFirstDerivatives.size() == outSamples.size());
+	MFA_ASSERT(outSecondDerivatives.empty() == true || outSecondDerivatives.size() == outSamples.size());
+
+	auto const maxC = MaxSupport(cConstants);
+	auto const writeFirst = outFirstDerivatives.empty() == false;
+	auto const writeSecond = outSecondDerivatives.empty() == false;
+
+#ifdef USE_OMP
+	#pragma omp parallel for
+#endif
+	for (int k = firstSample; k < lastSample; ++k)
 	{
 		auto const u = (k * deltaU) + deltaU;
-		std::vector<float> weights(controlPoints.size());
-		float weightSum = 0.0f;
-		for (int i = 0; i < static_cast<int>(weights.size()); ++i)
+
+		int first, last;
+		SupportWindow(u, maxC, static_cast<int>(controlPoints.size()), first, last);
+
+		// C = N / W with N = sum(w_i * P_i) and W = sum(w_i)
+		glm::vec3 n0{}, n1{}, n2{};
+		float w0 = 0.0f, w1 = 0.0f, w2 = 0.0f;
+		for (int i = first; i <= last; ++i)
+		{
+			float weight, firstDerivative, secondDerivative;
+			CalcWeightDerivatives(
+				interpolate,
+				u - static_cast<float>(i),
+				cConstants[i],
+				kConstants[i],
+				weight,
+				firstDerivative,
+				secondDerivative
+			);
+			n0 += weight * controlPoints[i];
+			n1 += firstDerivative * controlPoints[i];
+			n2 += secondDerivative * controlPoints[i];
+			w0 += weight;
+			w1 += firstDerivative;
+			w2 += secondDerivative;
+		}
+
+		outIsValid[k] = w0 > 0.0f;
+		if (w0 == 0.0f)
 		{
-			weights[i] = CalcA(u, static_cast<float>(i), cConstants[i], kConstants[i]);
-			if (interpolate == true)
+			outSamples[k] = n0;
+			if (writeFirst == true)
+			{
+				outFirstDerivatives[k] = {};
+			}
+			if (writeSecond == true)
 			{
-				weights[i] *= CalcI(u, static_cast<float>(i));
+				outSecondDerivatives[k] = {};
 			}
-			weightSum += weights[i];
+			continue;
+		}
+
+		// C' = (N' - C W') / W and C'' = (N'' - 2 C' W' - C W'') / W
+		auto const c0 = n0 / w0;
+		auto const c1 = (n1 - c0 * w1) / w0;
+		outSamples[k] = c0;
+		if (writeFirst == true)
+		{
+			outFirstDerivatives[k] = c1;
+		}
+		if (writeSecond == true)
+		{
+			outSecondDerivatives[k] = (n2 - 2.0f * c1 * w1 - c0 * w2) / w0;
+		}
+	}
+}
+
+//-----------------------------------------------------
+
+int Cinpact::Generate(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	std::span<glm::vec3> const output,
+	std::span<glm::vec3> const outFirstDerivatives,
+	std::span<glm::vec3> const outSecondDerivatives
+)
+{
+	auto const stepCount = SampleCount(static_cast<int>(controlPoints.size()), deltaU);
+	MFA_ASSERT(static_cast<int>(output.size()) >= stepCount);
+	MFA_ASSERT(outFirstDerivatives.empty() == true || static_cast<int>(outFirstDerivatives.size()) >= stepCount);
+	MFA_ASSERT(outSecondDerivatives.empty() == true || static_cast<int>(outSecondDerivatives.size()) >= stepCount);
+
+	auto & samples = samplesScratch;
+	samples.resize(stepCount);
+	auto & isValid = isValidScratch;
+	isValid.resize(stepCount);
+	auto & firstDerivatives = firstDerivativesScratch;
+	firstDerivatives.resize(outFirstDerivatives.empty() == true ? 0 : stepCount);
+	auto & secondDerivatives = secondDerivativesScratch;
+	secondDerivatives.resize(outSecondDerivatives.empty() == true ? 0 : stepCount);
+
+	GenerateRange(
+		interpolate,
+		controlPoints,
+		cConstants,
+		kConstants,
+		deltaU,
+		0,
+		stepCount,
+		samples,
+		firstDerivatives,
+		secondDerivatives,
+		isValid
+	);
+
+	int validCount = 0;
+	for (int k = 0; k < stepCount; ++k)
+	{
+		if (isValid[k] == 0)
+		{
+			continue;
+		}
+		output[validCount] = samples[k];
+		if (firstDerivatives.empty() == false)
+		{
+			outFirstDerivatives[validCount] = firstDerivatives[k];
+		}
+		if (secondDerivatives.empty() == false)
+		{
+			outSecondDerivatives[validCount] = secondDerivatives[k];
+		}
+		++validCount;
+	}
+	return validCount;
+}
+
+//-----------------------------------------------------
+
+float Cinpact::Curvature(glm::vec3 const & firstDerivative, glm::vec3 const & secondDerivative)
+{
+	auto const speed = glm::length(firstDerivative);
+	if (speed == 0.0f)
+	{
+		return 0.0f;
+	}
+	return glm::length(glm::cross(firstDerivative, secondDerivative)) / (speed * speed * speed);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateAdaptive(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	AdaptiveTolerance const & tolerance,
+	std::vector<glm::vec3> & output,
+	std::vector<float> & outParameters
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(tolerance.minDeltaU > 0.0f);
+
+	output.clear();
+	outParameters.clear();
+
+	// The ends of the curve are left out like in Generate, which starts at deltaU. There is no deltaU here, so the
+	// range is [minDeltaU, n - 1 - minDeltaU]
+	auto const beginU = tolerance.minDeltaU;
+	auto const endU = static_cast<float>(controlPoints.size()) - 1.0f - tolerance.minDeltaU;
+	if (endU <= beginU)
+	{
+		return;
+	}
+
+	auto const maxC = MaxSupport(cConstants);
+	auto const spanCount = static_cast<int>(std::ceil(endU));
+	auto const cosMaxAngle = std::cos(tolerance.maxAngle);
+
+	// Each span keeps its own samples so that spans can be subdivided independently
+	auto & spanSamples = spanSamplesScratch;
+	auto & spanParameters = spanParametersScratch;
+	if (static_cast<int>(spanSamples.size()) < spanCount)
+	{
+		spanSamples.resize(spanCount);
+		spanParameters.resize(spanCount);
+	}
+
+	auto const evaluate = [&](float const u, glm::vec3 & outPoint) -> bool
+	{
+		glm::vec3 value;
+		auto const weightSum = EvaluateAt(interpolate, u, controlPoints, cConstants, kConstants, maxC, value);
+		outPoint = weightSum != 0.0f ? value / weightSum : value;
+		return weightSum > 0.0f;
+	};
+
+	// Distance to the chord itself and not to its line, a curve that runs past an end and back is not flat
+	auto const deviationSquare = [](AdaptiveSegment const & segment, glm::vec3 const & point) -> float
+	{
+		auto const chord = segment.end - segment.begin;
+		auto const chordLengthSquare = glm::dot(chord, chord);
+		auto offset = point - segment.begin;
+		if (chordLengthSquare > 0.0f)
+		{
+			offset -= chord * std::clamp(glm::dot(offset, chord) / chordLengthSquare, 0.0f, 1.0f);
+		}
+		return glm::dot(offset, offset);
+	};
+
+	// A segment is split while it is longer than minDeltaU and either a tested point is invalid, the middle or one of
+	// the quarter points is too far from the chord or the two halves bend too much. Testing only the middle misses
+	// bends that cancel out at the middle, the quarter points are needed anyway once the segment is split
+	auto const isFlat = [&](
+		AdaptiveSegment const & segment,
+		glm::vec3 const & firstQuarter,
+		glm::vec3 const & middle,
+		glm::vec3 const & lastQuarter
+	) -> bool
+	{
+		auto const maxDeviationSquare = tolerance.maxDeviation * tolerance.maxDeviation;
+		if (
+			deviationSquare(segment, middle) > maxDeviationSquare ||
+			deviationSquare(segment, firstQuarter) > maxDeviationSquare ||
+			deviationSquare(segment, lastQuarter) > maxDeviationSquare
+		)
+		{
+			return false;
+		}
+
+		auto const first = middle - segment.begin;
+		auto const second = segment.end - middle;
+		auto const lengthProduct = glm::length(first) * glm::length(second);
+		if (lengthProduct > 0.0f && glm::dot(first, second) < cosMaxAngle * lengthProduct)
+		{
+			return false;
+		}
+		return true;
+	};
+
+#ifdef USE_OMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int span = 0; span < spanCount; ++span)
+	{
+		auto & samples = spanSamples[span];
+		samples.clear();
+		auto & parameters = spanParameters[span];
+		parameters.clear();
+
+		auto const spanBeginU = std::max(beginU, static_cast<float>(span));
+		auto const spanEndU = std::min(endU, static_cast<float>(span + 1));
+
+		// Segments are pushed right to left so that they are popped, and their samples emitted, in the order of u
+		auto & stack = segmentStackScratch;
+		stack.clear();
+		glm::vec3 endPoint;
+		auto isEndValid = evaluate(spanEndU, endPoint);
+		for (int j = AdaptiveInitialSegments - 1; j >= 0; --j)
+		{
+			auto const t = static_cast<float>(j) / AdaptiveInitialSegments;
+			auto const segmentBeginU = j == 0 ? spanBeginU : spanBeginU + (spanEndU - spanBeginU) * t;
+			glm::vec3 beginPoint;
+			auto const isBeginValid = evaluate(segmentBeginU, beginPoint);
+			stack.emplace_back(AdaptiveSegment{
+				.beginU = segmentBeginU,
+				.endU = stack.empty() == true ? spanEndU : stack.back().beginU,
+				.begin = beginPoint,
+				.end = endPoint,
+				.isBeginValid = isBeginValid,
+				.isEndValid = isEndValid,
+				.hasMiddle = false
+			});
+			endPoint = beginPoint;
+			isEndValid = isBeginValid;
 		}
 
-		if (weightSum != 0.0f)
+		while (stack.empty() == false)
 		{
-			glm::vec3& value = result[k];
-			for (int i = 0; i < static_cast<int>(controlPoints.size()); ++i)
+			auto const segment = stack.back();
+			stack.pop_back();
+
+			if (segment.endU - segment.beginU > tolerance.minDeltaU)
+			{
+				auto const middleU = 0.5f * (segment.beginU + segment.endU);
+				auto middle = segment.middle;
+				auto isMiddleValid = segment.isMiddleValid;
+				if (segment.hasMiddle == false)
+				{
+					isMiddleValid = evaluate(middleU, middle);
+				}
+				glm::vec3 firstQuarter;
+				auto const isFirstQuarterValid = evaluate(0.5f * (segment.beginU + middleU), firstQuarter);
+				glm::vec3 lastQuarter;
+				auto const isLastQuarterValid = evaluate(0.5f * (middleU + segment.endU), lastQuarter);
+
+				auto const isValid = segment.isBeginValid && segment.isEndValid && isMiddleValid &&
+					isFirstQuarterValid && isLastQuarterValid;
+				if (isValid == false || isFlat(segment, firstQuarter, middle, lastQuarter) == false)
+				{
+					stack.emplace_back(AdaptiveSegment{
+						.beginU = middleU,
+						.endU = segment.endU,
+						.begin = middle,
+						.end = segment.end,
+						.isBeginValid = isMiddleValid,
+						.isEndValid = segment.isEndValid,
+						.hasMiddle = true,
+						.middle = lastQuarter,
+						.isMiddleValid = isLastQuarterValid
+					});
+					stack.emplace_back(AdaptiveSegment{
+						.beginU = segment.beginU,
+						.endU = middleU,
+						.begin = segment.begin,
+						.end = middle,
+						.isBeginValid = segment.isBeginValid,
+						.isEndValid = isMiddleValid,
+						.hasMiddle = true,
+						.middle = firstQuarter,
+						.isMiddleValid = isFirstQuarterValid
+					});
+					continue;
+				}
+			}
+
+			// The end of the segment is emitted as the beginning of the next one
+			if (segment.isBeginValid == true)
 			{
-				value += weights[i] * controlPoints[i];
+				samples.emplace_back(segment.begin);
+				parameters.emplace_back(segment.beginU);
 			}
-			value /= weightSum;
 		}
+	}
 
-		isValid[k] = weightSum > 0.0f;
+	size_t sampleCount = 1;
+	for (int span = 0; span < spanCount; ++span)
+	{
+		sampleCount += spanSamples[span].size();
+	}
+	output.reserve(sampleCount);
+	outParameters.reserve(sampleCount);
+	for (int span = 0; span < spanCount; ++span)
+	{
+		output.insert(output.end(), spanSamples[span].begin(), spanSamples[span].end());
+		outParameters.insert(outParameters.end(), spanParameters[span].begin(), spanParameters[span].end());
+	}
+
+	glm::vec3 lastPoint;
+	if (evaluate(endU, lastPoint) == true)
+	{
+		output.emplace_back(lastPoint);
+		outParameters.emplace_back(endU);
+	}
+}
+
+//-----------------------------------------------------
+
+int Cinpact::BatchSampleOffsets(CurveBatch const & batch, std::span<int> const outSampleOffsets)
+{
+	auto const curveCount = batch.CurveCount();
+	MFA_ASSERT(static_cast<int>(outSampleOffsets.size()) == curveCount + 1);
+
+	outSampleOffsets[0] = 0;
+	for (int j = 0; j < curveCount; ++j)
+	{
+		auto const controlPointCount = batch.controlPointOffsets[j + 1] - batch.controlPointOffsets[j];
+		outSampleOffsets[j + 1] = outSampleOffsets[j] + SampleCount(controlPointCount, batch.deltaU[j]);
 	}
+	return outSampleOffsets[curveCount];
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GenerateBatch(
+	CurveBatch const & batch,
+	std::span<int const> const sampleOffsets,
+	std::span<glm::vec3> const output,
+	std::span<int> const outValidCounts
+)
+{
+	auto const curveCount = batch.CurveCount();
+	MFA_ASSERT(static_cast<int>(sampleOffsets.size()) == curveCount + 1);
+	MFA_ASSERT(static_cast<int>(outValidCounts.size()) == curveCount);
+	MFA_ASSERT(static_cast<int>(output.size()) >= sampleOffsets[curveCount]);
+	MFA_ASSERT(batch.cConstants.size() == batch.controlPoints.size());
+	MFA_ASSERT(batch.kConstants.size() == batch.controlPoints.size());
 
-	for (int i = static_cast<int>(result.size()) - 1; i >= 0; --i)
+	auto const sampleCount = sampleOffsets[curveCount];
+
+	// Samples are evaluated in place on the grid of each curve and compacted per curve afterwards
+	auto & isValid = isValidScratch;
+	isValid.resize(sampleCount);
+	auto & maxSupport = maxSupportScratch;
+	maxSupport.resize(curveCount);
+	auto & usesBasisTable = usesBasisTableScratch;
+	usesBasisTable.resize(curveCount);
+
+	auto & workItems = workItemsScratch;
+	workItems.clear();
+	for (int j = 0; j < curveCount; ++j)
 	{
-		if (isValid[i] == false)
+		auto const curveSampleCount = sampleOffsets[j + 1] - sampleOffsets[j];
+		for (int first = 0; first < curveSampleCount; first += BatchChunkSize)
 		{
-			result.erase(result.begin() + i);
+			workItems.emplace_back(BatchWorkItem{
+				.curve = j,
+				.firstSample = first,
+				.lastSample = std::min(first + BatchChunkSize, curveSampleCount)
+			});
 		}
 	}
+	auto const workItemCount = static_cast<int>(workItems.size());
 
-#else
-	for (float u = deltaU; u <= static_cast<float>(controlPoints.size()) - 1.0 - deltaU; u += deltaU)
+	auto const curveSpans = [&batch](int const j, auto const & values)
 	{
-		std::vector<float> weights(controlPoints.size());
-		float weightSum = 0.0f;
-		for (int i = 0; i < static_cast<int>(weights.size()); ++i)
+		auto const first = batch.controlPointOffsets[j];
+		return values.subspan(first, batch.controlPointOffsets[j + 1] - first);
+	};
+
+#ifdef USE_OMP
+	#pragma omp parallel
+#endif
+	{
+		#pragma omp for schedule(static)
+		for (int j = 0; j < curveCount; ++j)
+		{
+			auto const cConstants = curveSpans(j, batch.cConstants);
+			maxSupport[j] = MaxSupport(cConstants);
+			usesBasisTable[j] = UsesBasisTable(cConstants, curveSpans(j, batch.kConstants), batch.deltaU[j]);
+		}
+
+		// Curves have very different lengths, so chunks are handed out dynamically
+		#pragma omp for schedule(dynamic)
+		for (int w = 0; w < workItemCount; ++w)
 		{
-			weights[i] = CalcA(u, static_cast<float>(i), cConstants[i], kConstants[i]);
-			if (interpolate == true)
+			auto const & item = workItems[w];
+			auto const j = item.curve;
+			auto const interpolate = batch.interpolate[j] != 0;
+			auto const deltaU = batch.deltaU[j];
+			auto const controlPoints = curveSpans(j, batch.controlPoints);
+			auto const cConstants = curveSpans(j, batch.cConstants);
+			auto const kConstants = curveSpans(j, batch.kConstants);
+
+			BasisTable const * basisTable = nullptr;
+			if (usesBasisTable[j] != 0)
 			{
-				weights[i] *= CalcI(u, static_cast<float>(i));
+				basisTable = GetBasisTable(interpolate, cConstants.front(), kConstants.front(), deltaU);
+			}
+
+			auto const sampleOffset = sampleOffsets[j];
+			for (int k = item.firstSample; k < item.lastSample; ++k)
+			{
+				glm::vec3 value;
+				auto const weightSum = EvaluateSample(
+					interpolate, k, deltaU, controlPoints, cConstants, kConstants, maxSupport[j], basisTable, value
+				);
+
+				output[sampleOffset + k] = weightSum != 0.0f ? value / weightSum : value;
+				isValid[sampleOffset + k] = weightSum > 0.0f;
 			}
-			weightSum += weights[i];
 		}
 
-		if (weightSum != 0.0f)
+		// Compacting in place is safe because samples only ever move towards the front
+		#pragma omp for schedule(static)
+		for (int j = 0; j < curveCount; ++j)
 		{
-			result.emplace_back();
-			glm::vec3& value = result.back();
-			for (int i = 0; i < static_cast<int>(controlPoints.size()); ++i)
+			auto outIdx = sampleOffsets[j];
+			for (int k = sampleOffsets[j]; k < sampleOffsets[j + 1]; ++k)
 			{
-				value += weights[i] * controlPoints[i];
+				if (isValid[k] != 0)
+				{
+					output[outIdx++] = output[k];
+				}
 			}
-			value /= weightSum;
+			outValidCounts[j] = outIdx - sampleOffsets[j];
 		}
 	}
-#endif
+}
 
-	return result;
+//-----------------------------------------------------
+
+int Cinpact::SampleCount(int const controlPointCount, float const deltaU)
+{
+	float stepCountF = static_cast<float>(controlPointCount) - 1.0f - 2.0f * deltaU;
+	stepCountF /= deltaU;
+	auto const stepCount = static_cast<int>(std::ceil(stepCountF));
+	return std::max(0, stepCount);
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::UsesBasisTable(
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU
+)
+{
+#ifdef USE_BASIS_TABLE
+	if (cConstants.empty() == true || SamplesPerUnit(deltaU) == 0)
+	{
+		return false;
+	}
+	auto const c = cConstants.front();
+	auto const k = kConstants.front();
+	for (int i = 1; i < static_cast<int>(cConstants.size()); ++i)
+	{
+		if (cConstants[i] != c || kConstants[i] != k)
+		{
+			return false;
+		}
+	}
+	auto const tableSize = 2.0 * std::max(c, 0.0f) * SamplesPerUnit(deltaU) + 1.0;
+	return tableSize <= MaxBasisTableSize;
+#else
+	return false;
+#endif
 }
 
 //-----------------------------------------------------
@@ -125,6 +1181,11 @@ float Cinpact::CalcA(float const u, float const i, float const c, float const k)
 float Cinpact::CalcI(float const u, float const i)
 {
 	auto const uMinI = u - i;
+	// Limit of sin(pi x) / (pi x) at x = 0, a sample that lands on a control point would otherwise get no weight from it
+	if (uMinI == 0.0f)
+	{
+		return 1.0f;
+	}
 	auto bottom = uMinI * glm::pi<float>();
 	if (bottom == 0.0f)
 	{
@@ -1,10 +1,21 @@
 #pragma once
 
 #include <vec3.hpp>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace Cinpact
 {
+	// How the partial evaluations below pick their weights. Detect calls UsesBasisTable, which scans c and k, on every
+	// call. Callers that evaluate the same curve many times can decide once and pass UseTable or Compute instead
+	enum class BasisTableMode : uint8_t
+	{
+		Detect,
+		UseTable,		// Only valid when UsesBasisTable is true for the inputs
+		Compute
+	};
+
 	std::vector<glm::vec3> Generate(
 		bool interpolate,
 		std::vector<glm::vec3> const & controlPoints, 
@@ -13,7 +24,170 @@ namespace Cinpact
 		float deltaU
 	);
 
+	// Allocation free version of Generate. Samples are written to output which must hold at least SampleCount items.
+	// Invalid samples are removed, returns the number of valid samples at the front of output
+	int Generate(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		std::span<glm::vec3> output
+	);
+
+	// Evaluates samples [firstSample, lastSample) of the grid u = (k + 1) * deltaU without removing the invalid ones.
+	// outSamples and outIsValid are indexed by k and must hold SampleCount items. maxC bounds the support of every
+	// control point, callers keep it between calls so that a partial evaluation does not scan cConstants
+	void GenerateRange(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		int firstSample,
+		int lastSample,
+		std::span<glm::vec3> outSamples,
+		std::span<uint8_t> outIsValid,
+		float maxC,
+		BasisTableMode basisTableMode = BasisTableMode::Detect
+	);
+
+	// Same as GenerateRange for the samples listed in sampleIndices, results are written at their index k
+	void GenerateSamples(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		std::span<int const> sampleIndices,
+		std::span<glm::vec3> outSamples,
+		std::span<uint8_t> outIsValid,
+		float maxC,
+		BasisTableMode basisTableMode = BasisTableMode::Detect
+	);
+
+	// Evaluates samples [firstSample, firstSample + outSamples.size()) of a curve that is too long to be held at once.
+	// controlPoints are the points [firstPoint, firstPoint + controlPoints.size()) of the curve and must include every
+	// point that reaches those samples. u is measured from firstPoint, so samples far along the curve keep their precision
+	void GenerateWindow(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		int64_t firstPoint,
+		int64_t firstSample,
+		std::span<glm::vec3> outSamples,
+		std::span<uint8_t> outIsValid
+	);
+
+	// Same as GenerateRange that also writes the first and second derivative of the curve with respect to u. The
+	// derivatives of the weights share the exp and sin terms of the weights. Pass empty spans to skip a derivative
+	void GenerateRange(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		int firstSample,
+		int lastSample,
+		std::span<glm::vec3> outSamples,
+		std::span<glm::vec3> outFirstDerivatives,
+		std::span<glm::vec3> outSecondDerivatives,
+		std::span<uint8_t> outIsValid
+	);
+
+	// Same as Generate with derivatives, item j of each output belongs to the same valid sample
+	int Generate(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		std::span<glm::vec3> output,
+		std::span<glm::vec3> outFirstDerivatives,
+		std::span<glm::vec3> outSecondDerivatives
+	);
+
+	// |C' x C''| / |C'|^3, zero where the curve has no tangent
+	[[nodiscard]]
+	float Curvature(glm::vec3 const & firstDerivative, glm::vec3 const & secondDerivative);
+
+	struct AdaptiveTolerance
+	{
+		float maxDeviation = 1e-3f;		// Distance of the middle and the quarter points of a segment to its chord
+		float maxAngle = 0.05f;			// Angle in radians between the two halves of a segment
+		float minDeltaU = 1e-3f;		// Segments shorter than this in u are never split
+	};
+
+	// Samples the curve densely where it bends and sparsely where it is straight. Each span [i, i + 1] between two
+	// control points is split in half until both tolerances are met. Spans are processed in parallel and output
+	// receives the valid samples in the order of u, outParameters their u
+	void GenerateAdaptive(
+		bool interpolate,
+		std::span<glm::vec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		AdaptiveTolerance const & tolerance,
+		std::vector<glm::vec3> & output,
+		std::vector<float> & outParameters
+	);
+
+	// Structure of arrays description of independent curves. Curve j owns the control points
+	// [controlPointOffsets[j], controlPointOffsets[j + 1]) of controlPoints, cConstants and kConstants
+	struct CurveBatch
+	{
+		std::span<int const> controlPointOffsets{};		// curveCount + 1 items
+		std::span<glm::vec3 const> controlPoints{};
+		std::span<float const> cConstants{};
+		std::span<float const> kConstants{};
+		std::span<float const> deltaU{};				// curveCount items
+		std::span<uint8_t const> interpolate{};			// curveCount items
+
+		[[nodiscard]]
+		int CurveCount() const
+		{
+			return static_cast<int>(controlPointOffsets.size()) - 1;
+		}
+	};
+
+	// Writes the prefix sum of the SampleCount of every curve to outSampleOffsets (curveCount + 1 items), returns the total
+	int BatchSampleOffsets(CurveBatch const & batch, std::span<int> outSampleOffsets);
+
+	// Evaluates all curves of the batch as a single parallel job of (curve, sample chunk) work items. The valid samples of
+	// curve j are written to the front of output[sampleOffsets[j], sampleOffsets[j + 1]) and their count to outValidCounts[j]
+	void GenerateBatch(
+		CurveBatch const & batch,
+		std::span<int const> sampleOffsets,
+		std::span<glm::vec3> output,
+		std::span<int> outValidCounts
+	);
+
+	// Number of samples that Generate evaluates before removing the invalid ones
+	[[nodiscard]]
+	int SampleCount(int controlPointCount, float deltaU);
+
+	// True when every control point shares c and k and 1 / deltaU is a whole number. The weights then only depend on
+	// how many samples away a control point is, so they are read from a cached table instead of being computed
+	[[nodiscard]]
+	bool UsesBasisTable(std::span<float const> cConstants, std::span<float const> kConstants, float deltaU);
+
 	float CalcA(float u, float i, float c, float k);
 
 	float CalcI(float u, float i);
+
+	// Batch version of CalcA * CalcI for control points [first, first + count), count weights are written to outWeights.
+	// Uses the widest instruction set the cpu supports and approximates exp/sin (see CinpactSimd.hpp for error bounds)
+	void CalcWeights(
+		bool interpolate,
+		float u,
+		int first,
+		int count,
+		float const * cConstants,
+		float const * kConstants,
+		float * outWeights
+	);
+
+	[[nodiscard]]
+	char const * SimdInstructionSet();
 }
@@ -0,0 +1,611 @@
+#include "CinpactEvaluator.hpp"
+
+#include "CinpactCurve.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm.hpp>
+
+//-----------------------------------------------------
+
+// Samples whose u lies within [idx - c, idx + c], widened by one sample on each side to absorb rounding of u
+static void AffectedSamples(
+	int const controlPointIdx,
+	float const c,
+	float const deltaU,
+	int const sampleCount,
+	int & outFirst,
+	int & outLast
+)
+{
+	auto const first = (static_cast<double>(controlPointIdx) - c) / deltaU - 1.0;
+	auto const last = (static_cast<double>(controlPointIdx) + c) / deltaU - 1.0;
+	outFirst = static_cast<int>(std::clamp(std::floor(first) - 1.0, 0.0, static_cast<double>(sampleCount)));
+	outLast = static_cast<int>(std::clamp(std::ceil(last) + 2.0, 0.0, static_cast<double>(sampleCount)));
+}
+
+//-----------------------------------------------------
+
+static float GridParameter(int const sampleIdx, float const deltaU)
+{
+	return (sampleIdx * deltaU) + deltaU;
+}
+
+//-----------------------------------------------------
+
+static Cinpact::BasisTableMode GetBasisTableMode(bool const usesBasisTable)
+{
+	return usesBasisTable == true ? Cinpact::BasisTableMode::UseTable : Cinpact::BasisTableMode::Compute;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::Evaluate(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU
+)
+{
+	_interpolate = interpolate;
+	_isAdaptive = false;
+	_deltaU = deltaU;
+	_controlPointCount = static_cast<int>(controlPoints.size());
+	_usesBasisTable = UsesBasisTable(cConstants, kConstants, deltaU);
+	_basisC = _usesBasisTable == true ? cConstants.front() : 0.0f;
+	_basisK = _usesBasisTable == true ? kConstants.front() : 0.0f;
+	_maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		_maxC = std::max(_maxC, c);
+	}
+
+	auto const sampleCount = SampleCount(_controlPointCount, deltaU);
+	_grid.resize(sampleCount);
+	_isValid.resize(sampleCount);
+
+	GenerateRange(
+		interpolate, controlPoints, cConstants, kConstants, deltaU, 0, sampleCount, _grid, _isValid,
+		_maxC, GetBasisTableMode(_usesBasisTable)
+	);
+
+	_samples.clear();
+	_parameters.clear();
+	for (int k = 0; k < sampleCount; ++k)
+	{
+		if (_isValid[k] != 0)
+		{
+			_samples.emplace_back(_grid[k]);
+			_parameters.emplace_back(GridParameter(k, deltaU));
+		}
+	}
+	_invalidCount = sampleCount - static_cast<int>(_samples.size());
+	BuildValidTree();
+
+	_isExact.assign(sampleCount, 1);
+	_pending = {};
+
+	_dirtyRange = {};
+	MarkDirty(0, static_cast<int>(_samples.size()));
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::EvaluateAdaptive(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	AdaptiveTolerance const & tolerance
+)
+{
+	_interpolate = interpolate;
+	_isAdaptive = true;
+	_tolerance = tolerance;
+	_controlPointCount = static_cast<int>(controlPoints.size());
+
+	GenerateAdaptive(interpolate, controlPoints, cConstants, kConstants, tolerance, _samples, _parameters);
+
+	_grid.clear();
+	_isValid.clear();
+	_validTree.clear();
+	_isExact.clear();
+	_invalidCount = 0;
+	_pending = {};
+
+	_dirtyRange = {};
+	MarkDirty(0, static_cast<int>(_samples.size()));
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::Update(
+	int const controlPointIdx,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants
+)
+{
+	MFA_ASSERT(static_cast<int>(controlPoints.size()) == _controlPointCount);
+	MFA_ASSERT(controlPointIdx >= 0 && controlPointIdx < _controlPointCount);
+
+	if (_isAdaptive == true)
+	{
+		EvaluateAdaptive(_interpolate, controlPoints, cConstants, kConstants, _tolerance);
+		return;
+	}
+
+	// Only the c and k of controlPointIdx can have changed. Leaving the table switches the affected samples to computed
+	// weights, the others keep table weights. Both only differ by the rounding of u, the table uses exact offsets.
+	// A curve that becomes uniform keeps computed weights
+	if (_usesBasisTable == true && (cConstants[controlPointIdx] != _basisC || kConstants[controlPointIdx] != _basisK))
+	{
+		_usesBasisTable = false;
+	}
+
+	_maxC = std::max(_maxC, cConstants[controlPointIdx]);
+
+	auto const sampleCount = static_cast<int>(_grid.size());
+	int first, last;
+	AffectedSamples(controlPointIdx, _maxC, _deltaU, sampleCount, first, last);
+	if (first >= last)
+	{
+		return;
+	}
+
+	_previousIsValid.assign(_isValid.begin() + first, _isValid.begin() + last);
+
+	GenerateRange(
+		_interpolate, controlPoints, cConstants, kConstants, _deltaU, first, last, _grid, _isValid,
+		_maxC, GetBasisTableMode(_usesBasisTable)
+	);
+	std::fill(_isExact.begin() + first, _isExact.begin() + last, 1);
+
+	Commit(first, last);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::UpdateProgressive(
+	int const controlPointIdx,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	int const coarseStride
+)
+{
+	MFA_ASSERT(static_cast<int>(controlPoints.size()) == _controlPointCount);
+	MFA_ASSERT(controlPointIdx >= 0 && controlPointIdx < _controlPointCount);
+	MFA_ASSERT(coarseStride > 0);
+
+	if (_isAdaptive == true)
+	{
+		EvaluateAdaptive(_interpolate, controlPoints, cConstants, kConstants, _tolerance);
+		return;
+	}
+
+	// Only the c and k of controlPointIdx can have changed. Leaving the table switches the affected samples to computed
+	// weights, the others keep table weights. Both only differ by the rounding of u, the table uses exact offsets.
+	// A curve that becomes uniform keeps computed weights
+	if (_usesBasisTable == true && (cConstants[controlPointIdx] != _basisC || kConstants[controlPointIdx] != _basisK))
+	{
+		_usesBasisTable = false;
+	}
+
+	_maxC = std::max(_maxC, cConstants[controlPointIdx]);
+
+	int first, last;
+	AffectedSamples(controlPointIdx, _maxC, _deltaU, static_cast<int>(_grid.size()), first, last);
+	if (first >= last)
+	{
+		return;
+	}
+
+	if (_pending.IsEmpty() == true)
+	{
+		_pending = Range{ .begin = first, .end = last };
+	}
+	else
+	{
+		_pending.begin = std::min(_pending.begin, first);
+		_pending.end = std::max(_pending.end, last);
+	}
+	_previousIsValid.assign(_isValid.begin() + _pending.begin, _isValid.begin() + _pending.end);
+
+	// The ends of the range are always evaluated so that the interpolation has an exact sample on both sides
+	std::fill(_isExact.begin() + first, _isExact.begin() + last, 0);
+	_pendingBatch.clear();
+	_pendingBatch.emplace_back(first);
+	for (int k = first - first % coarseStride + coarseStride; k < last - 1; k += coarseStride)
+	{
+		_pendingBatch.emplace_back(k);
+	}
+	if (last - 1 > first)
+	{
+		_pendingBatch.emplace_back(last - 1);
+	}
+	EvaluatePending(controlPoints, cConstants, kConstants);
+
+	_refineStride = coarseStride;
+	_refineCursor = _pending.end;
+
+	Interpolate(_pending.begin, _pending.end);
+	Commit(_pending.begin, _pending.end);
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::Evaluator::Refine(
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	std::chrono::steady_clock::duration const budget
+)
+{
+	static constexpr int BatchSize = 1024;
+
+	if (_pending.IsEmpty() == true)
+	{
+		return true;
+	}
+
+	MFA_ASSERT(static_cast<int>(controlPoints.size()) == _controlPointCount);
+
+	auto const startTime = std::chrono::steady_clock::now();
+
+	_previousIsValid.assign(_isValid.begin() + _pending.begin, _isValid.begin() + _pending.end);
+
+	bool isDone = false;
+	while (isDone == false)
+	{
+		_pendingBatch.clear();
+		while (static_cast<int>(_pendingBatch.size()) < BatchSize)
+		{
+			if (_refineCursor >= _pending.end)
+			{
+				if (_refineStride <= 1)
+				{
+					isDone = true;
+					break;
+				}
+				// Next level adds the samples in the middle of the current ones
+				_refineStride = std::max(1, _refineStride / 2);
+				_refineCursor = _pending.begin + (_refineStride - _pending.begin % _refineStride) % _refineStride;
+				continue;
+			}
+			if (_isExact[_refineCursor] == 0)
+			{
+				_pendingBatch.emplace_back(_refineCursor);
+			}
+			_refineCursor += _refineStride;
+		}
+
+		EvaluatePending(controlPoints, cConstants, kConstants);
+
+		if (std::chrono::steady_clock::now() - startTime >= budget)
+		{
+			break;
+		}
+	}
+
+	Interpolate(_pending.begin, _pending.end);
+	Commit(_pending.begin, _pending.end);
+
+	if (isDone == true)
+	{
+		_pending = {};
+	}
+
+	return isDone;
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::Evaluator::IsRefining() const
+{
+	return _pending.IsEmpty() == false;
+}
+
+//-----------------------------------------------------
+
+std::span<glm::vec3 const> Cinpact::Evaluator::Samples() const
+{
+	return _samples;
+}
+
+//-----------------------------------------------------
+
+std::span<float const> Cinpact::Evaluator::Parameters() const
+{
+	return _parameters;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::SetArcLengthEnabled(bool const enabled)
+{
+	if (enabled == _isArcLengthEnabled)
+	{
+		return;
+	}
+	_isArcLengthEnabled = enabled;
+	if (enabled == true)
+	{
+		_arcLength.Build(_samples);
+	}
+	else
+	{
+		_arcLength.Clear();
+	}
+}
+
+//-----------------------------------------------------
+
+float Cinpact::Evaluator::Length() const
+{
+	MFA_ASSERT(_isArcLengthEnabled == true);
+	return _arcLength.Length();
+}
+
+//-----------------------------------------------------
+
+float Cinpact::Evaluator::ParameterAtDistance(float const distance) const
+{
+	MFA_ASSERT(_isArcLengthEnabled == true);
+	if (_parameters.size() < 2)
+	{
+		return _parameters.empty() == true ? 0.0f : _parameters.front();
+	}
+	int sampleIdx;
+	float t;
+	SampleAtDistance(distance, sampleIdx, t);
+	return glm::mix(_parameters[sampleIdx], _parameters[sampleIdx + 1], t);
+}
+
+//-----------------------------------------------------
+
+glm::vec3 Cinpact::Evaluator::PositionAtDistance(float const distance) const
+{
+	MFA_ASSERT(_isArcLengthEnabled == true);
+	if (_samples.size() < 2)
+	{
+		return _samples.empty() == true ? glm::vec3{} : _samples.front();
+	}
+	int sampleIdx;
+	float t;
+	SampleAtDistance(distance, sampleIdx, t);
+	return glm::mix(_samples[sampleIdx], _samples[sampleIdx + 1], t);
+}
+
+//-----------------------------------------------------
+
+Cinpact::Evaluator::Range Cinpact::Evaluator::DirtyRange() const
+{
+	return _dirtyRange;
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::Evaluator::IsDirty() const
+{
+	return _isDirty;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::ClearDirtyRange()
+{
+	_dirtyRange = {};
+	_isDirty = false;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::Commit(int const first, int const last)
+{
+	int validInRange = 0;
+	int previousValidInRange = 0;
+	for (int k = first; k < last; ++k)
+	{
+		auto const previousIsValid = _previousIsValid[k - first];
+		if (_isValid[k] != previousIsValid)
+		{
+			UpdateValidTree(k, _isValid[k] - previousIsValid);
+		}
+		validInRange += _isValid[k];
+		previousValidInRange += previousIsValid;
+	}
+
+	// Position of the first affected sample inside the compacted samples
+	auto const compactedFirst = CompactedIndex(first);
+
+	// A different number of valid samples shifts everything after the range, the rest of the range is written in place
+	auto const countDelta = validInRange - previousValidInRange;
+	if (countDelta > 0)
+	{
+		auto const position = compactedFirst + previousValidInRange;
+		_samples.insert(_samples.begin() + position, countDelta, glm::vec3{});
+		_parameters.insert(_parameters.begin() + position, countDelta, 0.0f);
+	}
+	else if (countDelta < 0)
+	{
+		auto const position = compactedFirst + validInRange;
+		_samples.erase(_samples.begin() + position, _samples.begin() + position - countDelta);
+		_parameters.erase(_parameters.begin() + position, _parameters.begin() + position - countDelta);
+	}
+	_invalidCount -= countDelta;
+
+	auto outIdx = compactedFirst;
+	for (int k = first; k < last; ++k)
+	{
+		if (_isValid[k] != 0)
+		{
+			_samples[outIdx] = _grid[k];
+			_parameters[outIdx] = GridParameter(k, _deltaU);
+			++outIdx;
+		}
+	}
+
+	MarkDirty(compactedFirst, countDelta == 0 ? outIdx : static_cast<int>(_samples.size()));
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::BuildValidTree()
+{
+	auto const sampleCount = static_cast<int>(_isValid.size());
+	_validTree.assign(sampleCount + 1, 0);
+	// Linear time construction, each node passes its sum on to its parent
+	for (int node = 1; node <= sampleCount; ++node)
+	{
+		_validTree[node] += _isValid[node - 1];
+		auto const parent = node + (node & -node);
+		if (parent <= sampleCount)
+		{
+			_validTree[parent] += _validTree[node];
+		}
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::UpdateValidTree(int const sampleIdx, int const delta)
+{
+	auto const sampleCount = static_cast<int>(_isValid.size());
+	for (int node = sampleIdx + 1; node <= sampleCount; node += node & -node)
+	{
+		_validTree[node] += delta;
+	}
+}
+
+//-----------------------------------------------------
+
+int Cinpact::Evaluator::CompactedIndex(int const sampleIdx) const
+{
+	int validCount = 0;
+	for (int node = sampleIdx; node > 0; node -= node & -node)
+	{
+		validCount += _validTree[node];
+	}
+	return validCount;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::Interpolate(int const first, int const last)
+{
+	auto const sampleCount = static_cast<int>(_grid.size());
+
+	int k = first;
+	while (k < last)
+	{
+		if (_isExact[k] != 0)
+		{
+			++k;
+			continue;
+		}
+
+		// Run of pending samples [runBegin, runEnd), the samples around it are exact
+		auto const runBegin = k;
+		while (k < last && _isExact[k] == 0)
+		{
+			++k;
+		}
+		auto const runEnd = k;
+
+		auto const left = runBegin - 1;
+		auto const right = runEnd;
+		auto const hasLeft = left >= 0 && _isValid[left] != 0;
+		auto const hasRight = right < sampleCount && _isValid[right] != 0;
+		if (hasLeft == false && hasRight == false)
+		{
+			continue;
+		}
+
+		for (int j = runBegin; j < runEnd; ++j)
+		{
+			if (hasLeft == true && hasRight == true)
+			{
+				auto const t = static_cast<float>(j - left) / static_cast<float>(right - left);
+				_grid[j] = glm::mix(_grid[left], _grid[right], t);
+			}
+			else
+			{
+				_grid[j] = hasLeft == true ? _grid[left] : _grid[right];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::EvaluatePending(
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants
+)
+{
+	if (_pendingBatch.empty() == true)
+	{
+		return;
+	}
+	GenerateSamples(
+		_interpolate, controlPoints, cConstants, kConstants, _deltaU, _pendingBatch, _grid, _isValid,
+		_maxC, GetBasisTableMode(_usesBasisTable)
+	);
+	for (auto const k : _pendingBatch)
+	{
+		_isExact[k] = 1;
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::SampleAtDistance(float const distance, int & outSampleIdx, float & outT) const
+{
+	MFA_ASSERT(_samples.size() >= 2);
+	auto const point = _arcLength.PointAtDistance(distance);
+	// The last sample is reached as the end of the segment before it
+	outSampleIdx = std::min(static_cast<int>(point), static_cast<int>(_samples.size()) - 2);
+	outT = point - static_cast<float>(outSampleIdx);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::Evaluator::MarkDirty(int const begin, int const end)
+{
+	// The range is empty when samples were only removed from the end, the new count still has to reach the arc length
+	// table and the consumers
+	_isDirty = true;
+
+	if (_isArcLengthEnabled == true)
+	{
+		auto const sampleCount = static_cast<int>(_samples.size());
+		if (_arcLength.PointCount() != sampleCount || end - begin == sampleCount)
+		{
+			_arcLength.Build(_samples);
+		}
+		else if (begin < end)
+		{
+			_arcLength.Update(_samples, begin, end);
+		}
+	}
+
+	if (begin >= end)
+	{
+		return;
+	}
+	if (_dirtyRange.IsEmpty() == true)
+	{
+		_dirtyRange = Range{ .begin = begin, .end = end };
+		return;
+	}
+	_dirtyRange.begin = std::min(_dirtyRange.begin, begin);
+	_dirtyRange.end = std::max(_dirtyRange.end, end);
+}
+
+//-----------------------------------------------------
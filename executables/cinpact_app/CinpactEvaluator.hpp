@@ -0,0 +1,179 @@
+#pragma once
+
+#include "CinpactArcLength.hpp"
+#include "CinpactCurve.hpp"
+
+#include <vec3.hpp>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Keeps the samples of a curve between evaluations. Because of the compact support, moving a single control point
+	// only changes the samples around it, Update re-evaluates just those and reports which part of Samples() changed.
+	class Evaluator
+	{
+	public:
+
+		struct Range
+		{
+			int begin = 0;
+			int end = 0;
+
+			[[nodiscard]]
+			bool IsEmpty() const
+			{
+				return begin >= end;
+			}
+		};
+
+		// Evaluates every sample of the curve
+		void Evaluate(
+			bool interpolate,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			float deltaU
+		);
+
+		// Samples the curve with GenerateAdaptive instead of a uniform deltaU. The sample count depends on the shape of
+		// the whole curve, so Update and UpdateProgressive evaluate it again completely until the next Evaluate call
+		void EvaluateAdaptive(
+			bool interpolate,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			AdaptiveTolerance const & tolerance
+		);
+
+		// Re-evaluates the samples that controlPointIdx can influence after its position, c or k changed.
+		// All other inputs must be the same as in the last Evaluate call.
+		void Update(
+			int controlPointIdx,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants
+		);
+
+		// Live version of Update for interactive edits. Only every coarseStride-th affected sample is evaluated right away,
+		// the samples in between are linearly interpolated and marked as pending until Refine evaluates them.
+		void UpdateProgressive(
+			int controlPointIdx,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			int coarseStride
+		);
+
+		// Evaluates pending samples, halving the stride level by level, until budget is spent. Progress is kept between
+		// calls. Returns true once no sample is pending.
+		bool Refine(
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			std::chrono::steady_clock::duration budget
+		);
+
+		[[nodiscard]]
+		bool IsRefining() const;
+
+		// Valid samples in the order of u
+		[[nodiscard]]
+		std::span<glm::vec3 const> Samples() const;
+
+		// u of every item of Samples()
+		[[nodiscard]]
+		std::span<float const> Parameters() const;
+
+		// Keeps a cumulative arc length table of Samples() up to date, only the segments around the dirty samples are
+		// measured again. Required by the distance queries below
+		void SetArcLengthEnabled(bool enabled);
+
+		[[nodiscard]]
+		float Length() const;
+
+		// Constant speed lookups, distance is measured along the samples from the first one. O(log n)
+		[[nodiscard]]
+		float ParameterAtDistance(float distance) const;
+
+		[[nodiscard]]
+		glm::vec3 PositionAtDistance(float distance) const;
+
+		// Part of Samples() that changed since the last ClearDirtyRange call
+		[[nodiscard]]
+		Range DirtyRange() const;
+
+		// True when Samples() changed since the last ClearDirtyRange call. Unlike DirtyRange this includes samples that
+		// were only removed from the end, where the new count is the only change
+		[[nodiscard]]
+		bool IsDirty() const;
+
+		void ClearDirtyRange();
+
+	private:
+
+		void MarkDirty(int begin, int end);
+
+		void SampleAtDistance(float distance, int & outSampleIdx, float & outT) const;
+
+		// Copies the grid samples [first, last) into the compacted samples, _previousIsValid holds the validity of the
+		// range before it was modified
+		void Commit(int first, int last);
+
+		void BuildValidTree();
+
+		void UpdateValidTree(int sampleIdx, int delta);
+
+		// Number of valid grid samples before sampleIdx, which is its position inside the compacted samples. O(log n)
+		[[nodiscard]]
+		int CompactedIndex(int sampleIdx) const;
+
+		// Fills the pending samples of [first, last) by interpolating between the closest exact samples
+		void Interpolate(int first, int last);
+
+		void EvaluatePending(
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants
+		);
+
+		bool _interpolate = false;
+		float _deltaU = 0.0f;
+		int _controlPointCount = 0;
+		// Generate switches between the basis table and computed weights, see Cinpact::UsesBasisTable. Decided by
+		// Evaluate, the partial evaluations never scan c and k again. An edit that breaks the uniform c and k only
+		// switches the samples it affects to computed weights
+		bool _usesBasisTable = false;
+		float _basisC = 0.0f;
+		float _basisK = 0.0f;
+		bool _isAdaptive = false;
+		AdaptiveTolerance _tolerance{};
+		// Widest support seen since the last Evaluate, the previous c of a moved point is never larger than this
+		float _maxC = 0.0f;
+
+		// Uniform grid u = (k + 1) * deltaU including the invalid samples
+		std::vector<glm::vec3> _grid{};
+		std::vector<uint8_t> _isValid{};
+		std::vector<uint8_t> _previousIsValid{};
+		int _invalidCount = 0;
+		// 1-based Fenwick tree over _isValid, keeps the compacted positions up to date as the validity changes
+		std::vector<int> _validTree{};
+
+		std::vector<glm::vec3> _samples{};
+		std::vector<float> _parameters{};
+		Range _dirtyRange{};
+		bool _isDirty = false;
+
+		// Progressive refinement, every sample outside _pending is exact
+		std::vector<uint8_t> _isExact{};
+		Range _pending{};
+		int _refineStride = 0;
+		int _refineCursor = 0;
+		std::vector<int> _pendingBatch{};
+
+		bool _isArcLengthEnabled = false;
+		ArcLengthTable _arcLength{};
+	};
+}
@@ -0,0 +1,259 @@
+#include "CinpactFile.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// The arrays are used in place, so the file layout has to match the memory layout
+static_assert(std::endian::native == std::endian::little);
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+
+static constexpr uint64_t ChecksumSeed = 0xCBF29CE484222325ull;
+
+//-----------------------------------------------------
+
+// FNV-1a over 8 byte words, the bytes that do not fill a word are hashed one by one
+static uint64_t Checksum(uint64_t hash, void const * data, size_t const size)
+{
+	static constexpr uint64_t Prime = 0x100000001B3ull;
+
+	auto const * bytes = static_cast<uint8_t const *>(data);
+	auto const wordCount = size / sizeof(uint64_t);
+	for (size_t i = 0; i < wordCount; ++i)
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+		hash ^= word;
+		hash *= Prime;
+	}
+	for (size_t i = wordCount * sizeof(uint64_t); i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= Prime;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------
+
+// Size of everything after the header
+static uint64_t BodySize(uint64_t const pointCount, uint64_t const namesSize)
+{
+	return pointCount * (sizeof(glm::vec3) + 2 * sizeof(float) + sizeof(uint32_t)) + sizeof(uint32_t) + namesSize;
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::SaveCurveFile(std::string const & path, CurveFileContent const & content)
+{
+	auto const pointCount = content.controlPoints.size();
+	MFA_ASSERT(content.cConstants.size() == pointCount);
+	MFA_ASSERT(content.kConstants.size() == pointCount);
+	MFA_ASSERT(content.names.empty() == true || content.names.size() == pointCount);
+
+	std::vector<uint32_t> nameOffsets(pointCount + 1, 0);
+	std::string names{};
+	for (size_t i = 0; i < content.names.size(); ++i)
+	{
+		names += content.names[i];
+		if (names.size() > std::numeric_limits<uint32_t>::max())
+		{
+			MFA_LOG_ERROR("Names of %s do not fit in the string table", path.c_str());
+			return false;
+		}
+		nameOffsets[i + 1] = static_cast<uint32_t>(names.size());
+	}
+
+	CurveFileHeader header{};
+	if (content.interpolate == true)
+	{
+		header.flags |= CurveFileHeader::Interpolate;
+	}
+	header.deltaU = content.deltaU;
+	header.pointCount = pointCount;
+	header.namesSize = names.size();
+
+	auto checksum = ChecksumSeed;
+	checksum = Checksum(checksum, content.controlPoints.data(), content.controlPoints.size_bytes());
+	checksum = Checksum(checksum, content.cConstants.data(), content.cConstants.size_bytes());
+	checksum = Checksum(checksum, content.kConstants.data(), content.kConstants.size_bytes());
+	checksum = Checksum(checksum, nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+	checksum = Checksum(checksum, names.data(), names.size());
+	header.checksum = checksum;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (file.good() == false)
+	{
+		MFA_LOG_ERROR("Failed to open %s for writing", path.c_str());
+		return false;
+	}
+
+	auto const write = [&file](void const * data, size_t const size)
+	{
+		file.write(static_cast<char const *>(data), static_cast<std::streamsize>(size));
+	};
+	write(&header, sizeof(header));
+	write(content.controlPoints.data(), content.controlPoints.size_bytes());
+	write(content.cConstants.data(), content.cConstants.size_bytes());
+	write(content.kConstants.data(), content.kConstants.size_bytes());
+	write(nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+	write(names.data(), names.size());
+
+	file.close();
+	if (file.fail() == true)
+	{
+		MFA_LOG_ERROR("Failed to write %s", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------
+
+std::shared_ptr<Cinpact::CurveFile> Cinpact::CurveFile::Load(std::string const & path, bool const verifyChecksum)
+{
+	auto mapping = MFA::File::Map(path);
+	if (mapping == nullptr)
+	{
+		MFA_LOG_ERROR("Failed to map %s", path.c_str());
+		return nullptr;
+	}
+
+	if (mapping->Len() < sizeof(CurveFileHeader))
+	{
+		MFA_LOG_ERROR("%s is too small to be a curve file", path.c_str());
+		return nullptr;
+	}
+
+	auto const * header = reinterpret_cast<CurveFileHeader const *>(mapping->Ptr());
+	if (header->magic != CurveFileHeader::Magic || header->version != CurveFileHeader::Version)
+	{
+		MFA_LOG_ERROR("%s is not a version %u curve file", path.c_str(), CurveFileHeader::Version);
+		return nullptr;
+	}
+
+	// Checked one by one so that a corrupt header can not overflow the size computation
+	auto const bodySize = mapping->Len() - sizeof(CurveFileHeader);
+	if (header->pointCount > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+		header->namesSize > bodySize ||
+		BodySize(header->pointCount, header->namesSize) != bodySize)
+	{
+		MFA_LOG_ERROR("%s is truncated or has a corrupt header", path.c_str());
+		return nullptr;
+	}
+
+	std::shared_ptr<CurveFile> curveFile{new CurveFile(std::move(mapping))};
+
+	if (verifyChecksum == true)
+	{
+		auto checksum = ChecksumSeed;
+		checksum = Checksum(checksum, curveFile->_controlPoints.data(), curveFile->_controlPoints.size_bytes());
+		checksum = Checksum(checksum, curveFile->_cConstants.data(), curveFile->_cConstants.size_bytes());
+		checksum = Checksum(checksum, curveFile->_kConstants.data(), curveFile->_kConstants.size_bytes());
+		checksum = Checksum(checksum, curveFile->_nameOffsets.data(), curveFile->_nameOffsets.size_bytes());
+		checksum = Checksum(checksum, curveFile->_names, header->namesSize);
+		if (checksum != header->checksum)
+		{
+			MFA_LOG_ERROR("%s failed the checksum", path.c_str());
+			return nullptr;
+		}
+	}
+
+	// Names are read in place, offsets that leave the string table would read past the mapping
+	auto const & nameOffsets = curveFile->_nameOffsets;
+	if (nameOffsets.front() != 0 || nameOffsets.back() != header->namesSize)
+	{
+		MFA_LOG_ERROR("%s has a corrupt string table", path.c_str());
+		return nullptr;
+	}
+	for (size_t i = 1; i < nameOffsets.size(); ++i)
+	{
+		if (nameOffsets[i] < nameOffsets[i - 1])
+		{
+			MFA_LOG_ERROR("%s has a corrupt string table", path.c_str());
+			return nullptr;
+		}
+	}
+
+	return curveFile;
+}
+
+//-----------------------------------------------------
+
+Cinpact::CurveFile::CurveFile(std::shared_ptr<MFA::File::Mapping> mapping)
+	: _mapping(std::move(mapping))
+{
+	auto const * bytes = _mapping->Ptr();
+	_header = reinterpret_cast<CurveFileHeader const *>(bytes);
+	bytes += sizeof(CurveFileHeader);
+
+	auto const pointCount = static_cast<size_t>(_header->pointCount);
+	_controlPoints = {reinterpret_cast<glm::vec3 const *>(bytes), pointCount};
+	bytes += _controlPoints.size_bytes();
+	_cConstants = {reinterpret_cast<float const *>(bytes), pointCount};
+	bytes += _cConstants.size_bytes();
+	_kConstants = {reinterpret_cast<float const *>(bytes), pointCount};
+	bytes += _kConstants.size_bytes();
+	_nameOffsets = {reinterpret_cast<uint32_t const *>(bytes), pointCount + 1};
+	bytes += _nameOffsets.size_bytes();
+	_names = reinterpret_cast<char const *>(bytes);
+}
+
+//-----------------------------------------------------
+
+bool Cinpact::CurveFile::Interpolate() const
+{
+	return (_header->flags & CurveFileHeader::Interpolate) != 0;
+}
+
+//-----------------------------------------------------
+
+float Cinpact::CurveFile::DeltaU() const
+{
+	return _header->deltaU;
+}
+
+//-----------------------------------------------------
+
+int Cinpact::CurveFile::PointCount() const
+{
+	return static_cast<int>(_controlPoints.size());
+}
+
+//-----------------------------------------------------
+
+std::span<glm::vec3 const> Cinpact::CurveFile::ControlPoints() const
+{
+	return _controlPoints;
+}
+
+//-----------------------------------------------------
+
+std::span<float const> Cinpact::CurveFile::CConstants() const
+{
+	return _cConstants;
+}
+
+//-----------------------------------------------------
+
+std::span<float const> Cinpact::CurveFile::KConstants() const
+{
+	return _kConstants;
+}
+
+//-----------------------------------------------------
+
+std::string_view Cinpact::CurveFile::Name(int const pointIdx) const
+{
+	MFA_ASSERT(pointIdx >= 0 && pointIdx < PointCount());
+	auto const begin = _nameOffsets[pointIdx];
+	return {_names + begin, _nameOffsets[pointIdx + 1] - begin};
+}
+
+//-----------------------------------------------------
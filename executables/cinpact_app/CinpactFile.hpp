@@ -0,0 +1,95 @@
+#pragma once
+
+#include "BedrockFile.hpp"
+
+#include <vec3.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Cinpact
+{
+	// Little endian binary curve file. A 64 byte header is followed by arrays of pointCount items:
+	// positions (3 floats), c, k, name offsets (pointCount + 1 uint32 into the string table) and then the string table.
+	// The checksum chains a 64 bit FNV-1a hash over the 8 byte words of each of these sections
+	struct CurveFileHeader
+	{
+		static constexpr uint32_t Magic = 0x54504E43;		// "CNPT"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t magic = Magic;
+		uint32_t version = Version;
+		uint32_t flags = 0;
+		float deltaU = 0.0f;
+		uint64_t pointCount = 0;
+		uint64_t namesSize = 0;
+		uint64_t checksum = 0;
+		uint64_t reserved[3]{};
+
+		enum Flags : uint32_t
+		{
+			Interpolate = 1u << 0
+		};
+	};
+	static_assert(sizeof(CurveFileHeader) == 64);
+
+	struct CurveFileContent
+	{
+		bool interpolate = true;
+		float deltaU = 1e-2f;
+		std::span<glm::vec3 const> controlPoints{};
+		std::span<float const> cConstants{};
+		std::span<float const> kConstants{};
+		std::span<std::string const> names{};				// Empty or one name per control point
+	};
+
+	// Returns false if the file can not be written
+	bool SaveCurveFile(std::string const & path, CurveFileContent const & content);
+
+	// Curve file that is mapped into memory. The spans point into the mapping, so they can be passed to the evaluator
+	// without a copy and the pages are only read when they are used
+	class CurveFile
+	{
+	public:
+
+		// Returns nullptr if the file is missing, truncated, of another version or fails the checksum. Skipping the
+		// checksum avoids reading the whole file up front
+		static std::shared_ptr<CurveFile> Load(std::string const & path, bool verifyChecksum = true);
+
+		[[nodiscard]]
+		bool Interpolate() const;
+
+		[[nodiscard]]
+		float DeltaU() const;
+
+		[[nodiscard]]
+		int PointCount() const;
+
+		[[nodiscard]]
+		std::span<glm::vec3 const> ControlPoints() const;
+
+		[[nodiscard]]
+		std::span<float const> CConstants() const;
+
+		[[nodiscard]]
+		std::span<float const> KConstants() const;
+
+		[[nodiscard]]
+		std::string_view Name(int pointIdx) const;
+
+	private:
+
+		// The mapping must hold a file that passed the checks of Load
+		explicit CurveFile(std::shared_ptr<MFA::File::Mapping> mapping);
+
+		std::shared_ptr<MFA::File::Mapping> _mapping{};
+		CurveFileHeader const * _header = nullptr;
+		std::span<glm::vec3 const> _controlPoints{};
+		std::span<float const> _cConstants{};
+		std::span<float const> _kConstants{};
+		std::span<uint32_t const> _nameOffsets{};
+		char const * _names = nullptr;
+	};
+}
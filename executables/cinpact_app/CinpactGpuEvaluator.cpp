@@ -0,0 +1,571 @@
+#include "CinpactGpuEvaluator.hpp"
+
+#include "CinpactCurve.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+#include "BedrockPath.hpp"
+#include "DescriptorSetSchema.hpp"
+#include "ImportShader.hpp"
+#include "LogicalDevice.hpp"
+#include "RenderBackend.hpp"
+
+#include <geometric.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace MFA;
+
+// Has to match GROUP_SIZE of the shader
+static constexpr int GroupSize = 256;
+// Lowest maxComputeWorkGroupCount[0] that Vulkan guarantees, larger dispatches continue on the next row
+static constexpr uint32_t MaxGroupCountX = 65535;
+static constexpr uint32_t BindingCount = 7;
+
+enum class Pass : uint32_t
+{
+	Evaluate = 0,
+	Scan = 1,
+	Compact = 2
+};
+
+//-----------------------------------------------------
+
+static void BufferBarrier(
+	VkCommandBuffer const commandBuffer,
+	RT::BufferAndMemory const & buffer,
+	VkPipelineStageFlags const srcStage,
+	VkAccessFlags const srcAccess,
+	VkPipelineStageFlags const dstStage,
+	VkAccessFlags const dstAccess
+)
+{
+	VkBufferMemoryBarrier const barrier{
+		.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+		.srcAccessMask = srcAccess,
+		.dstAccessMask = dstAccess,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.buffer = buffer.buffer,
+		.offset = 0,
+		.size = VK_WHOLE_SIZE
+	};
+	RB::PipelineBarrier(commandBuffer, srcStage, dstStage, 1, &barrier);
+}
+
+//-----------------------------------------------------
+
+std::shared_ptr<Cinpact::GpuEvaluator> Cinpact::GpuEvaluator::Create()
+{
+	auto * device = LogicalDevice::Instance;
+
+	// The vertex buffer is written on the compute queue and read on the graphic queue without an ownership transfer
+	if (device->GetComputeQueueFamily() != device->GetGraphicQueueFamily())
+	{
+		MFA_LOG_WARN("Gpu evaluation needs the compute and graphic queue to be of the same family");
+		return nullptr;
+	}
+
+	auto const cpuShader = Importer::ShaderFromSPV(
+		Path::Instance->Get("engine/shaders/cinpact_pipeline/CinpactPipeline.comp.spv"),
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		"main"
+	);
+	if (cpuShader == nullptr)
+	{
+		return nullptr;
+	}
+	auto const gpuShader = RB::CreateShader(device->GetVkDevice(), cpuShader);
+
+	return std::make_shared<GpuEvaluator>(gpuShader);
+}
+
+//-----------------------------------------------------
+
+Cinpact::GpuEvaluator::GpuEvaluator(std::shared_ptr<RT::GpuShader> const & shader)
+{
+	MFA_ASSERT(shader != nullptr);
+
+	auto const maxFramesPerFlight = LogicalDevice::Instance->GetMaxFramePerFlight();
+	// The pool reserves maxSets descriptors of each type
+	_descriptorPool = RB::CreateDescriptorPool(
+		LogicalDevice::Instance->GetVkDevice(),
+		BindingCount * maxFramesPerFlight
+	);
+	CreateDescriptorSetLayout();
+	CreatePipeline(*shader);
+	_descriptorSetGroup = RB::CreateDescriptorSet(
+		LogicalDevice::Instance->GetVkDevice(),
+		_descriptorPool->descriptorPool,
+		_descriptorSetLayout->descriptorSetLayout,
+		maxFramesPerFlight
+	);
+}
+
+//-----------------------------------------------------
+
+Cinpact::GpuEvaluator::~GpuEvaluator()
+{
+	_pipeline = nullptr;
+	_descriptorSetLayout = nullptr;
+	_descriptorPool = nullptr;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::Evaluate(
+	RT::CommandRecordState & recordState,
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU
+)
+{
+	MFA_ASSERT(recordState.commandBufferType == RT::CommandBufferType::Compute);
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+
+	auto const controlPointCount = static_cast<int>(controlPoints.size());
+	_sampleCount = Cinpact::SampleCount(controlPointCount, deltaU);
+	if (_sampleCount == 0)
+	{
+		return;
+	}
+
+	Reserve(controlPointCount, _sampleCount);
+
+	// BeginCommandBuffer waited for the compute fence of this frame, so its input buffers are no longer read
+	auto const vkDevice = LogicalDevice::Instance->GetVkDevice();
+	auto const frameIndex = recordState.frameIndex;
+	RB::UpdateHostVisibleBuffer(vkDevice, *_positions->buffers[frameIndex], Alias{ controlPoints.data(), controlPoints.size() });
+	RB::UpdateHostVisibleBuffer(vkDevice, *_cConstants->buffers[frameIndex], Alias{ cConstants.data(), cConstants.size() });
+	RB::UpdateHostVisibleBuffer(vkDevice, *_kConstants->buffers[frameIndex], Alias{ kConstants.data(), kConstants.size() });
+
+	auto const commandBuffer = recordState.commandBuffer;
+
+	// The compute and graphic queue are the same queue, so the draws of earlier frames are ordered before this barrier.
+	// Only their reads have to finish before the buffers are written again
+	BufferBarrier(
+		commandBuffer, *_vertices,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_drawArguments,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+	);
+	// The scratch buffers were last written by the previous evaluation
+	BufferBarrier(
+		commandBuffer, *_samples,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_groupOffsets,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+	);
+
+	RB::BindPipeline(recordState, *_pipeline);
+	RB::AutoBindDescriptorSet(recordState, RB::UpdateFrequency::PerPipeline, _descriptorSetGroup);
+
+	float maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		maxC = std::max(maxC, c);
+	}
+
+	auto const groupCount = static_cast<uint32_t>((_sampleCount + GroupSize - 1) / GroupSize);
+	auto const groupCountX = std::min(groupCount, MaxGroupCountX);
+	auto const groupCountY = (groupCount + groupCountX - 1) / groupCountX;
+
+	PushConstants pushConstants{
+		.pass = static_cast<uint32_t>(Pass::Evaluate),
+		.controlPointCount = static_cast<uint32_t>(controlPointCount),
+		.sampleCount = static_cast<uint32_t>(_sampleCount),
+		.interpolate = interpolate == true ? 1u : 0u,
+		.deltaU = deltaU,
+		.maxC = maxC,
+		.groupCountX = groupCountX
+	};
+	Dispatch(recordState, pushConstants, groupCountX, groupCountY);
+
+	BufferBarrier(
+		commandBuffer, *_groupOffsets,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+	);
+
+	pushConstants.pass = static_cast<uint32_t>(Pass::Scan);
+	Dispatch(recordState, pushConstants, 1, 1);
+
+	BufferBarrier(
+		commandBuffer, *_groupOffsets,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_samples,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+	);
+
+	pushConstants.pass = static_cast<uint32_t>(Pass::Compact);
+	Dispatch(recordState, pushConstants, groupCountX, groupCountY);
+
+	BufferBarrier(
+		commandBuffer, *_vertices,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_drawArguments,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+	);
+
+	// The graphic commands bind their own pipelines
+	recordState.pipeline = nullptr;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::Draw(RT::CommandRecordState const & recordState) const
+{
+	if (_sampleCount == 0)
+	{
+		return;
+	}
+
+	RB::BindVertexBuffer(recordState, *_vertices);
+	vkCmdDrawIndirect(
+		recordState.commandBuffer,
+		_drawArguments->buffer,
+		0,
+		1,
+		sizeof(VkDrawIndirectCommand)
+	);
+}
+
+//-----------------------------------------------------
+
+Cinpact::GpuEvaluator::ReadBackResult Cinpact::GpuEvaluator::ReadBack() const
+{
+	ReadBackResult result{};
+	if (_sampleCount == 0)
+	{
+		return result;
+	}
+
+	auto * device = LogicalDevice::Instance;
+	auto const vkDevice = device->GetVkDevice();
+
+	auto const drawArgumentsSize = static_cast<VkDeviceSize>(sizeof(VkDrawIndirectCommand));
+	auto const samplesSize = static_cast<VkDeviceSize>(_sampleCount) * sizeof(glm::vec4);
+	auto const verticesSize = static_cast<VkDeviceSize>(_sampleCount) * sizeof(glm::vec3);
+	auto const readBuffer = RB::CreateBuffer(
+		vkDevice,
+		device->GetPhysicalDevice(),
+		drawArgumentsSize + samplesSize + verticesSize,
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	);
+
+	auto const commandBuffer = RB::BeginSingleTimeCommand(vkDevice, device->GetComputeCommandPool());
+	BufferBarrier(
+		commandBuffer, *_drawArguments,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_samples,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT
+	);
+	BufferBarrier(
+		commandBuffer, *_vertices,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT
+	);
+	VkBufferCopy const drawArgumentsCopy{ .srcOffset = 0, .dstOffset = 0, .size = drawArgumentsSize };
+	vkCmdCopyBuffer(commandBuffer, _drawArguments->buffer, readBuffer->buffer, 1, &drawArgumentsCopy);
+	VkBufferCopy const samplesCopy{ .srcOffset = 0, .dstOffset = drawArgumentsSize, .size = samplesSize };
+	vkCmdCopyBuffer(commandBuffer, _samples->buffer, readBuffer->buffer, 1, &samplesCopy);
+	VkBufferCopy const verticesCopy{ .srcOffset = 0, .dstOffset = drawArgumentsSize + samplesSize, .size = verticesSize };
+	vkCmdCopyBuffer(commandBuffer, _vertices->buffer, readBuffer->buffer, 1, &verticesCopy);
+	RB::EndAndSubmitSingleTimeCommand(vkDevice, device->GetComputeCommandPool(), device->GetComputeQueue(), commandBuffer);
+
+	void * data = nullptr;
+	RB::MapHostVisibleMemory(vkDevice, readBuffer->memory, 0, readBuffer->size, &data);
+	auto const * bytes = static_cast<uint8_t const *>(data);
+
+	VkDrawIndirectCommand drawArguments{};
+	std::memcpy(&drawArguments, bytes, sizeof(drawArguments));
+	MFA_ASSERT(drawArguments.vertexCount <= static_cast<uint32_t>(_sampleCount));
+
+	result.samples.resize(_sampleCount);
+	std::memcpy(result.samples.data(), bytes + drawArgumentsSize, samplesSize);
+	result.vertices.resize(drawArguments.vertexCount);
+	std::memcpy(result.vertices.data(), bytes + drawArgumentsSize + samplesSize, result.vertices.size() * sizeof(glm::vec3));
+
+	RB::UnMapHostVisibleMemory(vkDevice, readBuffer->memory);
+
+	return result;
+}
+
+//-----------------------------------------------------
+
+Cinpact::GpuEvaluator::Comparison Cinpact::GpuEvaluator::CompareWithCpu(
+	bool const interpolate,
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU
+) const
+{
+	Comparison comparison{};
+	comparison.sampleCount = Cinpact::SampleCount(static_cast<int>(controlPoints.size()), deltaU);
+	if (comparison.sampleCount != _sampleCount)
+	{
+		// Evaluated with different inputs, every sample counts as a mismatch
+		comparison.validityMismatches = std::max(comparison.sampleCount, _sampleCount);
+		return comparison;
+	}
+
+	auto const gpu = ReadBack();
+
+	float maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		maxC = std::max(maxC, c);
+	}
+
+	std::vector<glm::vec3> samples(comparison.sampleCount);
+	std::vector<uint8_t> isValid(comparison.sampleCount);
+	Cinpact::GenerateRange(
+		interpolate, controlPoints, cConstants, kConstants, deltaU, 0, comparison.sampleCount, samples, isValid, maxC
+	);
+
+	int validIdx = 0;
+	for (int k = 0; k < comparison.sampleCount; ++k)
+	{
+		auto const & gpuSample = gpu.samples[k];
+		auto const isGpuValid = gpuSample.w > 0.5f;
+		if (isGpuValid != (isValid[k] != 0))
+		{
+			++comparison.validityMismatches;
+		}
+		else if (isGpuValid == true)
+		{
+			comparison.maxError = std::max(comparison.maxError, glm::distance(glm::vec3{gpuSample}, samples[k]));
+		}
+
+		if (isGpuValid == true)
+		{
+			if (validIdx >= static_cast<int>(gpu.vertices.size()) || gpu.vertices[validIdx] != glm::vec3{gpuSample})
+			{
+				++comparison.compactionMismatches;
+			}
+			++validIdx;
+		}
+	}
+	comparison.compactionMismatches += std::abs(static_cast<int>(gpu.vertices.size()) - validIdx);
+
+	return comparison;
+}
+
+//-----------------------------------------------------
+
+int Cinpact::GpuEvaluator::SampleCount() const
+{
+	return _sampleCount;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::CreateDescriptorSetLayout()
+{
+	std::vector<VkDescriptorSetLayoutBinding> bindings{};
+	for (uint32_t binding = 0; binding < BindingCount; ++binding)
+	{
+		bindings.emplace_back(VkDescriptorSetLayoutBinding{
+			.binding = binding,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.descriptorCount = 1,
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+		});
+	}
+
+	MFA_ASSERT(_descriptorSetLayout == nullptr);
+	_descriptorSetLayout = RB::CreateDescriptorSetLayout(
+		LogicalDevice::Instance->GetVkDevice(),
+		static_cast<uint8_t>(bindings.size()),
+		bindings.data()
+	);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::CreatePipeline(RT::GpuShader const & shader)
+{
+	std::vector<VkPushConstantRange> const pushConstantRanges{
+		VkPushConstantRange {
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof(PushConstants),
+		}
+	};
+	auto const pipelineLayout = RB::CreatePipelineLayout(
+		LogicalDevice::Instance->GetVkDevice(),
+		1,
+		&_descriptorSetLayout->descriptorSetLayout,
+		static_cast<uint32_t>(pushConstantRanges.size()),
+		pushConstantRanges.data()
+	);
+
+	_pipeline = RB::CreateComputePipeline(
+		LogicalDevice::Instance->GetVkDevice(),
+		shader,
+		pipelineLayout
+	);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::Reserve(int const controlPointCount, int const sampleCount)
+{
+	auto * device = LogicalDevice::Instance;
+	bool isReallocated = false;
+
+	// Released before the new ones are created to lower the peak, destroying a buffer waits until the device is idle
+	if (controlPointCount > _controlPointCapacity)
+	{
+		_controlPointCapacity = std::max({ controlPointCount, _controlPointCapacity * 2, 64 });
+		_positions.reset();
+		_cConstants.reset();
+		_kConstants.reset();
+
+		auto const createInput = [device](VkDeviceSize const size)->std::shared_ptr<RT::BufferGroup>
+		{
+			return RB::CreateBufferGroup(
+				device->GetVkDevice(),
+				device->GetPhysicalDevice(),
+				size,
+				device->GetMaxFramePerFlight(),
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			);
+		};
+		_positions = createInput(_controlPointCapacity * sizeof(glm::vec3));
+		_cConstants = createInput(_controlPointCapacity * sizeof(float));
+		_kConstants = createInput(_controlPointCapacity * sizeof(float));
+		isReallocated = true;
+	}
+
+	if (sampleCount > _sampleCapacity)
+	{
+		_sampleCapacity = std::max({ sampleCount, _sampleCapacity * 2, GroupSize });
+		_samples.reset();
+		_groupOffsets.reset();
+		_vertices.reset();
+		_drawArguments.reset();
+
+		auto const groupCapacity = (_sampleCapacity + GroupSize - 1) / GroupSize;
+		_samples = RB::CreateBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			_sampleCapacity * sizeof(glm::vec4),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		_groupOffsets = RB::CreateBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			groupCapacity * sizeof(uint32_t),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		_vertices = RB::CreateBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			_sampleCapacity * sizeof(glm::vec3),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		_drawArguments = RB::CreateBuffer(
+			device->GetVkDevice(),
+			device->GetPhysicalDevice(),
+			sizeof(VkDrawIndirectCommand),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		isReallocated = true;
+	}
+
+	// The device was idle when the old buffers were destroyed, so none of the sets is in use
+	if (isReallocated == true)
+	{
+		UpdateDescriptorSets();
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::UpdateDescriptorSets()
+{
+	auto const maxFramesPerFlight = LogicalDevice::Instance->GetMaxFramePerFlight();
+	for (uint32_t frameIndex = 0; frameIndex < maxFramesPerFlight; ++frameIndex)
+	{
+		auto const & descriptorSet = _descriptorSetGroup.descriptorSets[frameIndex];
+		MFA_ASSERT(descriptorSet != VK_NULL_HANDLE);
+
+		// Same order as the bindings of the shader
+		RT::BufferAndMemory const * buffers[BindingCount]{
+			_positions->buffers[frameIndex].get(),
+			_cConstants->buffers[frameIndex].get(),
+			_kConstants->buffers[frameIndex].get(),
+			_samples.get(),
+			_groupOffsets.get(),
+			_vertices.get(),
+			_drawArguments.get()
+		};
+
+		VkDescriptorBufferInfo bufferInfos[BindingCount];
+		DescriptorSetSchema descriptorSetSchema{ descriptorSet };
+		for (uint32_t binding = 0; binding < BindingCount; ++binding)
+		{
+			bufferInfos[binding] = VkDescriptorBufferInfo{
+				.buffer = buffers[binding]->buffer,
+				.offset = 0,
+				.range = buffers[binding]->size,
+			};
+			descriptorSetSchema.AddStorageBuffer(&bufferInfos[binding]);
+		}
+		descriptorSetSchema.UpdateDescriptorSets();
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::GpuEvaluator::Dispatch(
+	RT::CommandRecordState & recordState,
+	PushConstants const & pushConstants,
+	uint32_t const groupCountX,
+	uint32_t const groupCountY
+) const
+{
+	RB::PushConstants(
+		recordState,
+		_pipeline->pipelineLayout,
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		0,
+		Alias{ &pushConstants, 1 }
+	);
+	vkCmdDispatch(recordState.commandBuffer, groupCountX, groupCountY, 1);
+}
+
+//-----------------------------------------------------
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+
+#include <vec3.hpp>
+#include <vec4.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Evaluates the uniform samples of a curve with a compute shader straight into a vertex buffer that LinePipeline
+	// draws from. The number of valid samples is only known on the gpu, so the curve is drawn indirectly
+	class GpuEvaluator
+	{
+	public:
+
+		// Content of the device buffers, for checking the shader against the cpu
+		struct ReadBackResult
+		{
+			std::vector<glm::vec4> samples{};		// Indexed by k, w is 1 for valid samples
+			std::vector<glm::vec3> vertices{};		// Valid samples in the order of u
+		};
+
+		struct Comparison
+		{
+			int sampleCount = 0;
+			float maxError = 0.0f;					// Largest distance between the gpu and cpu sample for any k
+			int validityMismatches = 0;
+			int compactionMismatches = 0;			// Vertices that are not the k-th valid sample of the gpu
+		};
+
+		// Returns nullptr if the shader is missing or the compute queue can not share buffers with the graphic queue
+		[[nodiscard]]
+		static std::shared_ptr<GpuEvaluator> Create();
+
+		explicit GpuEvaluator(std::shared_ptr<MFA::RT::GpuShader> const & shader);
+
+		~GpuEvaluator();
+
+		GpuEvaluator(GpuEvaluator const &) = delete;
+		GpuEvaluator & operator=(GpuEvaluator const &) = delete;
+
+		// Records the evaluation on the compute command buffer of recordState. The graphic commands of the same frame
+		// see the new vertices, earlier frames that still draw the old ones are waited for on the gpu
+		void Evaluate(
+			MFA::RT::CommandRecordState & recordState,
+			bool interpolate,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			float deltaU
+		);
+
+		// LinePipeline has to be bound
+		void Draw(MFA::RT::CommandRecordState const & recordState) const;
+
+		// Waits for the device, slow
+		[[nodiscard]]
+		ReadBackResult ReadBack() const;
+
+		// Evaluates the same curve with GenerateRange and compares it with what the last Evaluate left on the device
+		[[nodiscard]]
+		Comparison CompareWithCpu(
+			bool interpolate,
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants,
+			float deltaU
+		) const;
+
+		// Samples before removing the invalid ones, the vertex count is at most this
+		[[nodiscard]]
+		int SampleCount() const;
+
+	private:
+
+		struct PushConstants
+		{
+			uint32_t pass;
+			uint32_t controlPointCount;
+			uint32_t sampleCount;
+			uint32_t interpolate;
+			float deltaU;
+			float maxC;
+			uint32_t groupCountX;
+		};
+
+		void CreateDescriptorSetLayout();
+
+		void CreatePipeline(MFA::RT::GpuShader const & shader);
+
+		// Buffers are grown geometrically, the descriptor sets are written again whenever one of them is replaced
+		void Reserve(int controlPointCount, int sampleCount);
+
+		void UpdateDescriptorSets();
+
+		void Dispatch(
+			MFA::RT::CommandRecordState & recordState,
+			PushConstants const & pushConstants,
+			uint32_t groupCountX,
+			uint32_t groupCountY
+		) const;
+
+		std::shared_ptr<MFA::RT::DescriptorPool> _descriptorPool{};
+		std::shared_ptr<MFA::RT::DescriptorSetLayoutGroup> _descriptorSetLayout{};
+		std::shared_ptr<MFA::RT::PipelineGroup> _pipeline{};
+		MFA::RT::DescriptorSetGroup _descriptorSetGroup{};
+
+		// One buffer per frame in flight, written by the host right before the dispatch
+		std::shared_ptr<MFA::RT::BufferGroup> _positions{};
+		std::shared_ptr<MFA::RT::BufferGroup> _cConstants{};
+		std::shared_ptr<MFA::RT::BufferGroup> _kConstants{};
+		int _controlPointCapacity = 0;
+
+		std::shared_ptr<MFA::RT::BufferAndMemory> _samples{};
+		std::shared_ptr<MFA::RT::BufferAndMemory> _groupOffsets{};
+		std::shared_ptr<MFA::RT::BufferAndMemory> _vertices{};
+		std::shared_ptr<MFA::RT::BufferAndMemory> _drawArguments{};
+		int _sampleCapacity = 0;
+
+		int _sampleCount = 0;
+	};
+}
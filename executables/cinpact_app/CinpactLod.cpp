@@ -0,0 +1,131 @@
+#include "CinpactLod.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <geometric.hpp>
+
+#include <algorithm>
+
+//-----------------------------------------------------
+
+static float DistanceToSegment(glm::vec3 const & point, glm::vec3 const & a, glm::vec3 const & b)
+{
+	auto const ab = b - a;
+	auto const lengthSquare = glm::dot(ab, ab);
+	if (lengthSquare <= 0.0f)
+	{
+		return glm::distance(point, a);
+	}
+	auto const t = std::clamp(glm::dot(point - a, ab) / lengthSquare, 0.0f, 1.0f);
+	return glm::distance(point, a + t * ab);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PolylineLod::Build(std::span<glm::vec3 const> const points)
+{
+	auto const pointCount = static_cast<int>(points.size());
+	_errors.assign(pointCount, 0.0f);
+	if (pointCount > 0)
+	{
+		Refresh(points, 0, pointCount - 1, 0, pointCount);
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PolylineLod::Update(std::span<glm::vec3 const> const points, int const first, int const last)
+{
+	MFA_ASSERT(static_cast<int>(points.size()) == PointCount());
+	if (first < last && PointCount() > 0)
+	{
+		Refresh(points, 0, PointCount() - 1, first, last);
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PolylineLod::Clear()
+{
+	_errors.clear();
+}
+
+//-----------------------------------------------------
+
+int Cinpact::PolylineLod::PointCount() const
+{
+	return static_cast<int>(_errors.size());
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PolylineLod::Select(
+	std::span<glm::vec3 const> const points,
+	float const tolerance,
+	std::vector<glm::vec3> & outPoints
+) const
+{
+	MFA_ASSERT(static_cast<int>(points.size()) == PointCount());
+	outPoints.clear();
+	if (points.empty() == true)
+	{
+		return;
+	}
+	outPoints.emplace_back(points[0]);
+	if (PointCount() > 1)
+	{
+		Select(points, tolerance, 0, PointCount() - 1, outPoints);
+	}
+}
+
+//-----------------------------------------------------
+
+float Cinpact::PolylineLod::Refresh(
+	std::span<glm::vec3 const> const points,
+	int const begin,
+	int const end,
+	int const first,
+	int const last
+)
+{
+	if (end - begin < 2)
+	{
+		return 0.0f;
+	}
+	auto const middle = (begin + end) / 2;
+	if (end < first || begin >= last)
+	{
+		return _errors[middle];
+	}
+
+	// A point of either half is within the error of that half from its chord, and each half chord is within the
+	// distance of the middle point from the chord of the node
+	auto const childError = std::max(
+		Refresh(points, begin, middle, first, last),
+		Refresh(points, middle, end, first, last)
+	);
+	_errors[middle] = childError + DistanceToSegment(points[middle], points[begin], points[end]);
+	return _errors[middle];
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PolylineLod::Select(
+	std::span<glm::vec3 const> const points,
+	float const tolerance,
+	int const begin,
+	int const end,
+	std::vector<glm::vec3> & outPoints
+) const
+{
+	auto const middle = (begin + end) / 2;
+	if (end - begin < 2 || _errors[middle] <= tolerance)
+	{
+		outPoints.emplace_back(points[end]);
+		return;
+	}
+	Select(points, tolerance, begin, middle, outPoints);
+	Select(points, tolerance, middle, end, outPoints);
+}
+
+//-----------------------------------------------------
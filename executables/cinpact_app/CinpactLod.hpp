@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vec3.hpp>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Simplification hierarchy of a polyline. The point range is bisected recursively, every node keeps a bound on how
+	// far the points it covers are from its chord. Select cuts the tree at the coarsest nodes within a tolerance, so the
+	// number of points it returns depends on the tolerance rather than on the number of points in the polyline
+	class PolylineLod
+	{
+	public:
+
+		void Build(std::span<glm::vec3 const> points);
+
+		// Points [first, last) moved, the number of points must be the same as in the last Build call. Only the nodes
+		// that cover one of them are measured again
+		void Update(std::span<glm::vec3 const> points, int first, int last);
+
+		void Clear();
+
+		[[nodiscard]]
+		int PointCount() const;
+
+		// Replaces outPoints with a subset of points, in the same order, that stays within tolerance of every point.
+		// points must be the ones of the last Build or Update call
+		void Select(std::span<glm::vec3 const> points, float tolerance, std::vector<glm::vec3> & outPoints) const;
+
+	private:
+
+		// Returns the error of node [begin, end], nodes that do not cover a point of [first, last) keep their error
+		float Refresh(std::span<glm::vec3 const> points, int begin, int end, int first, int last);
+
+		void Select(std::span<glm::vec3 const> points, float tolerance, int begin, int end, std::vector<glm::vec3> & outPoints) const;
+
+		// Each node with at least one point between its ends is split at a distinct point, its error is stored there
+		std::vector<float> _errors{};
+	};
+}
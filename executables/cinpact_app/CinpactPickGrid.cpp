@@ -0,0 +1,150 @@
+#include "CinpactPickGrid.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//-----------------------------------------------------
+
+Cinpact::PickGrid::PickGrid(float const cellSize)
+	: _cellSize(cellSize)
+{
+	MFA_ASSERT(cellSize > 0.0f);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Build(SlotMap const & slotMap, std::span<glm::vec3 const> const positions)
+{
+	MFA_ASSERT(static_cast<int>(positions.size()) == slotMap.Count());
+	Clear();
+	_cells.reserve(positions.size());
+	for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+	{
+		Insert(slotMap.HandleOf(i), positions[i]);
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Clear()
+{
+	_cells.clear();
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Insert(Handle const handle, glm::vec2 const & position)
+{
+	_cells[Key(CellOf(position))].emplace_back(handle);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Move(Handle const handle, glm::vec2 const & from, glm::vec2 const & to)
+{
+	auto const fromKey = Key(CellOf(from));
+	auto const toKey = Key(CellOf(to));
+	if (fromKey == toKey)
+	{
+		return;
+	}
+	Erase(fromKey, handle);
+	_cells[toKey].emplace_back(handle);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Remove(Handle const handle, glm::vec2 const & position)
+{
+	Erase(Key(CellOf(position)), handle);
+}
+
+//-----------------------------------------------------
+
+Cinpact::Handle Cinpact::PickGrid::FindNearest(
+	glm::vec2 const & position,
+	float const radius,
+	SlotMap const & slotMap,
+	std::span<glm::vec3 const> const positions
+) const
+{
+	MFA_ASSERT(static_cast<int>(positions.size()) == slotMap.Count());
+
+	auto const minCell = CellOf(position - radius);
+	auto const maxCell = CellOf(position + radius);
+
+	Handle nearest{};
+	int nearestIdx = -1;
+	float nearestDistance = radius * radius;
+	for (int x = minCell.x; x <= maxCell.x; ++x)
+	{
+		for (int y = minCell.y; y <= maxCell.y; ++y)
+		{
+			auto const cell = _cells.find(Key({x, y}));
+			if (cell == _cells.end())
+			{
+				continue;
+			}
+			for (auto const handle : cell->second)
+			{
+				auto const idx = slotMap.IndexOf(handle);
+				MFA_ASSERT(idx >= 0);
+				auto const offset = glm::vec2{positions[idx]} - position;
+				auto const distance = glm::dot(offset, offset);
+				// Ties go to the point that comes first on the curve, like the linear search did
+				if (distance < nearestDistance || (distance == nearestDistance && nearestIdx >= 0 && idx < nearestIdx))
+				{
+					nearest = handle;
+					nearestIdx = idx;
+					nearestDistance = distance;
+				}
+			}
+		}
+	}
+	return nearest;
+}
+
+//-----------------------------------------------------
+
+glm::ivec2 Cinpact::PickGrid::CellOf(glm::vec2 const & position) const
+{
+	// Clamped so that far away points share the border cells instead of overflowing
+	auto const toCell = [this](float const value)
+	{
+		auto const cell = std::floor(value / _cellSize);
+		auto const limit = static_cast<float>(std::numeric_limits<int>::max() / 2);
+		return static_cast<int>(std::clamp(cell, -limit, limit));
+	};
+	return {toCell(position.x), toCell(position.y)};
+}
+
+//-----------------------------------------------------
+
+uint64_t Cinpact::PickGrid::Key(glm::ivec2 const & cell)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32) | static_cast<uint32_t>(cell.y);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::PickGrid::Erase(uint64_t const key, Handle const handle)
+{
+	auto const cell = _cells.find(key);
+	MFA_ASSERT(cell != _cells.end());
+	auto & handles = cell->second;
+	auto const item = std::find(handles.begin(), handles.end(), handle);
+	MFA_ASSERT(item != handles.end());
+	*item = handles.back();
+	handles.pop_back();
+	if (handles.empty() == true)
+	{
+		_cells.erase(cell);
+	}
+}
+
+//-----------------------------------------------------
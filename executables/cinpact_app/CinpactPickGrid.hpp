@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CinpactSlotMap.hpp"
+
+#include <vec2.hpp>
+#include <vec3.hpp>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Cinpact
+{
+	// Uniform grid over the xy of the control points for picking. Cells are hashed, so only occupied cells take memory
+	// and a query only visits the cells within the pick radius no matter how many points there are
+	class PickGrid
+	{
+	public:
+
+		explicit PickGrid(float cellSize);
+
+		// positions are the column of slotMap
+		void Build(SlotMap const & slotMap, std::span<glm::vec3 const> positions);
+
+		void Clear();
+
+		void Insert(Handle handle, glm::vec2 const & position);
+
+		void Move(Handle handle, glm::vec2 const & from, glm::vec2 const & to);
+
+		void Remove(Handle handle, glm::vec2 const & position);
+
+		// Closest point within radius of position or an invalid handle. positions must be the column of slotMap that
+		// the grid is kept in sync with
+		[[nodiscard]]
+		Handle FindNearest(
+			glm::vec2 const & position,
+			float radius,
+			SlotMap const & slotMap,
+			std::span<glm::vec3 const> positions
+		) const;
+
+	private:
+
+		[[nodiscard]]
+		glm::ivec2 CellOf(glm::vec2 const & position) const;
+
+		[[nodiscard]]
+		static uint64_t Key(glm::ivec2 const & cell);
+
+		// Removes handle from the cell of key, empty cells are dropped
+		void Erase(uint64_t key, Handle handle);
+
+		float _cellSize;
+		std::unordered_map<uint64_t, std::vector<Handle>> _cells{};
+	};
+}
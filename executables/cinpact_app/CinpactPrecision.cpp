@@ -0,0 +1,298 @@
+#include "CinpactPrecision.hpp"
+
+#include "CinpactCurve.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <ext/scalar_constants.hpp>
+#include <geometric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#define USE_OMP
+
+//-----------------------------------------------------
+
+// Same as Cinpact::CalcA and Cinpact::CalcI, with u - i passed in so that it can be computed in a wider type
+
+template<typename T>
+static T CalcAFromOffset(T const uMinI, T const c, T const k)
+{
+	if (uMinI < -c || uMinI > c)
+	{
+		return T(0);
+	}
+
+	auto const uMinISquare = uMinI * uMinI;
+
+	auto bottom = (c * c) - uMinISquare;
+	if (bottom == T(0))
+	{
+		bottom += glm::epsilon<T>();
+	}
+
+	return std::exp(-k * uMinISquare / bottom);
+}
+
+//-----------------------------------------------------
+
+template<typename T>
+static T CalcIFromOffset(T const uMinI)
+{
+	if (uMinI == T(0))
+	{
+		return T(1);
+	}
+	auto bottom = uMinI * glm::pi<T>();
+	if (bottom == T(0))
+	{
+		bottom += glm::epsilon<T>();
+	}
+	return std::sin(glm::pi<T>() * uMinI) / bottom;
+}
+
+//-----------------------------------------------------
+
+template<typename WeightT, typename AccumT>
+void Cinpact::GenerateRange(
+	bool const interpolate,
+	std::span<glm::vec<3, AccumT> const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	AccumT const deltaU,
+	int const firstSample,
+	int const lastSample,
+	std::span<glm::vec<3, AccumT>> const outSamples,
+	std::span<uint8_t> const outIsValid
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+	MFA_ASSERT(firstSample >= 0 && lastSample <= static_cast<int>(outSamples.size()));
+	MFA_ASSERT(outIsValid.size() == outSamples.size());
+
+	float maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		maxC = std::max(maxC, c);
+	}
+	auto const lastIdx = static_cast<AccumT>(controlPoints.size()) - AccumT(1);
+
+#ifdef USE_OMP
+	#pragma omp parallel for
+#endif
+	for (int k = firstSample; k < lastSample; ++k)
+	{
+		auto const u = (k * deltaU) + deltaU;
+		auto const first = static_cast<int>(std::ceil(std::clamp(u - maxC, AccumT(0), lastIdx)));
+		auto const last = static_cast<int>(std::floor(std::clamp(u + maxC, AccumT(0), lastIdx)));
+
+		glm::vec<3, AccumT> value{};
+		AccumT weightSum = 0;
+		for (int i = first; i <= last; ++i)
+		{
+			auto const uMinI = static_cast<WeightT>(u - static_cast<AccumT>(i));
+			auto weight = CalcAFromOffset<WeightT>(uMinI, cConstants[i], kConstants[i]);
+			if (interpolate == true)
+			{
+				weight *= CalcIFromOffset<WeightT>(uMinI);
+			}
+			value += static_cast<AccumT>(weight) * controlPoints[i];
+			weightSum += static_cast<AccumT>(weight);
+		}
+
+		outSamples[k] = weightSum != AccumT(0) ? value / weightSum : value;
+		outIsValid[k] = weightSum > AccumT(0);
+	}
+}
+
+//-----------------------------------------------------
+
+template<typename AccumT>
+static thread_local std::vector<glm::vec<3, AccumT>> samplesScratch{};
+static thread_local std::vector<uint8_t> isValidScratch{};
+
+//-----------------------------------------------------
+
+template<typename WeightT, typename AccumT>
+int Cinpact::Generate(
+	bool const interpolate,
+	std::span<glm::vec<3, AccumT> const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	AccumT const deltaU,
+	std::span<glm::vec<3, AccumT>> const output
+)
+{
+	auto const stepCount = SampleCount(static_cast<int>(controlPoints.size()), static_cast<float>(deltaU));
+	MFA_ASSERT(static_cast<int>(output.size()) >= stepCount);
+
+	auto & samples = samplesScratch<AccumT>;
+	samples.resize(stepCount);
+	auto & isValid = isValidScratch;
+	isValid.resize(stepCount);
+
+	GenerateRange<WeightT, AccumT>(
+		interpolate, controlPoints, cConstants, kConstants, deltaU, 0, stepCount, samples, isValid
+	);
+
+	int validCount = 0;
+	for (int k = 0; k < stepCount; ++k)
+	{
+		if (isValid[k] != 0)
+		{
+			output[validCount++] = samples[k];
+		}
+	}
+	return validCount;
+}
+
+//-----------------------------------------------------
+
+#define INSTANTIATE_PRECISION(WeightT, AccumT)															\
+	template void Cinpact::GenerateRange<WeightT, AccumT>(												\
+		bool, std::span<glm::vec<3, AccumT> const>, std::span<float const>, std::span<float const>,		\
+		AccumT, int, int, std::span<glm::vec<3, AccumT>>, std::span<uint8_t>							\
+	);																									\
+	template int Cinpact::Generate<WeightT, AccumT>(														\
+		bool, std::span<glm::vec<3, AccumT> const>, std::span<float const>, std::span<float const>,		\
+		AccumT, std::span<glm::vec<3, AccumT>>															\
+	);
+
+INSTANTIATE_PRECISION(float, float)
+INSTANTIATE_PRECISION(double, double)
+INSTANTIATE_PRECISION(float, double)
+
+#undef INSTANTIATE_PRECISION
+
+//-----------------------------------------------------
+
+// Average time of repetitions calls to evaluate in milliseconds
+template<typename Function>
+static double Measure(int const repetitions, Function const & evaluate)
+{
+	auto const startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < repetitions; ++i)
+	{
+		evaluate();
+	}
+	auto const duration = std::chrono::steady_clock::now() - startTime;
+	return std::chrono::duration<double, std::milli>(duration).count() / repetitions;
+}
+
+//-----------------------------------------------------
+
+template<typename AccumT>
+static void MeasureError(
+	std::span<glm::dvec3 const> const reference,
+	std::span<uint8_t const> const referenceIsValid,
+	std::span<glm::vec<3, AccumT> const> const samples,
+	std::span<uint8_t const> const isValid,
+	Cinpact::PrecisionBenchmarkResult & result
+)
+{
+	int comparedCount = 0;
+	double errorSum = 0.0;
+	for (int k = 0; k < static_cast<int>(reference.size()); ++k)
+	{
+		if (referenceIsValid[k] != isValid[k])
+		{
+			++result.validityMismatches;
+			continue;
+		}
+		if (isValid[k] == 0)
+		{
+			continue;
+		}
+		auto const error = glm::distance(reference[k], glm::dvec3{ samples[k] });
+		result.maxError = std::max(result.maxError, error);
+		errorSum += error;
+		++comparedCount;
+	}
+	result.meanError = comparedCount > 0 ? errorSum / comparedCount : 0.0;
+}
+
+//-----------------------------------------------------
+
+std::vector<Cinpact::PrecisionBenchmarkResult> Cinpact::BenchmarkPrecision(
+	bool const interpolate,
+	std::span<glm::dvec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants,
+	float const deltaU,
+	int const repetitions
+)
+{
+	MFA_ASSERT(repetitions > 0);
+
+	auto const sampleCount = SampleCount(static_cast<int>(controlPoints.size()), deltaU);
+	// The same grid of u for every mode, deltaU is widened instead of rounded again
+	auto const deltaUd = static_cast<double>(deltaU);
+
+	std::vector<glm::vec3> const controlPointsF(controlPoints.begin(), controlPoints.end());
+	float maxC = 0.0f;
+	for (auto const c : cConstants)
+	{
+		maxC = std::max(maxC, c);
+	}
+
+	std::vector<glm::dvec3> reference(sampleCount);
+	std::vector<uint8_t> referenceIsValid(sampleCount);
+	std::vector<glm::dvec3> samplesD(sampleCount);
+	std::vector<glm::vec3> samplesF(sampleCount);
+	std::vector<uint8_t> isValid(sampleCount);
+
+	std::vector<PrecisionBenchmarkResult> results{};
+
+	auto const addResult = [&](char const * name, double const milliseconds) -> PrecisionBenchmarkResult &
+	{
+		auto & result = results.emplace_back();
+		result.name = name;
+		result.milliseconds = milliseconds;
+		result.samplesPerSecond = milliseconds > 0.0 ? sampleCount / (milliseconds * 1e-3) : 0.0;
+		return result;
+	};
+
+	{
+		auto const milliseconds = Measure(repetitions, [&]
+		{
+			GenerateRange<double, double>(
+				interpolate, controlPoints, cConstants, kConstants, deltaUd, 0, sampleCount, reference, referenceIsValid
+			);
+		});
+		addResult("double", milliseconds);
+	}
+	{
+		auto const milliseconds = Measure(repetitions, [&]
+		{
+			GenerateRange<float, double>(
+				interpolate, controlPoints, cConstants, kConstants, deltaUd, 0, sampleCount, samplesD, isValid
+			);
+		});
+		MeasureError<double>(reference, referenceIsValid, samplesD, isValid, addResult("mixed", milliseconds));
+	}
+	{
+		auto const milliseconds = Measure(repetitions, [&]
+		{
+			GenerateRange<float, float>(
+				interpolate, controlPointsF, cConstants, kConstants, deltaU, 0, sampleCount, samplesF, isValid
+			);
+		});
+		MeasureError<float>(reference, referenceIsValid, samplesF, isValid, addResult("float", milliseconds));
+	}
+	{
+		auto const milliseconds = Measure(repetitions, [&]
+		{
+			GenerateRange(
+				interpolate, controlPointsF, cConstants, kConstants, deltaU, 0, sampleCount, samplesF, isValid, maxC
+			);
+		});
+		MeasureError<float>(reference, referenceIsValid, samplesF, isValid, addResult("float (default)", milliseconds));
+	}
+
+	return results;
+}
+
+//-----------------------------------------------------
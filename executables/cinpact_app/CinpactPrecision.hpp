@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vec3.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Scalar evaluation with a selectable precision. Weights are computed in WeightT from u - i, which is always taken in
+	// AccumT, and the weighted sums are accumulated in AccumT. Instantiated for:
+	// float/float:   same precision as Generate, without the SIMD kernel and the basis table
+	// double/double: reference precision
+	// float/double:  float weights with double accumulation, u - i stays exact far from the origin
+	template<typename WeightT, typename AccumT>
+	void GenerateRange(
+		bool interpolate,
+		std::span<glm::vec<3, AccumT> const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		AccumT deltaU,
+		int firstSample,
+		int lastSample,
+		std::span<glm::vec<3, AccumT>> outSamples,
+		std::span<uint8_t> outIsValid
+	);
+
+	// Returns the number of valid samples at the front of output, which must hold at least SampleCount items
+	template<typename WeightT, typename AccumT>
+	int Generate(
+		bool interpolate,
+		std::span<glm::vec<3, AccumT> const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		AccumT deltaU,
+		std::span<glm::vec<3, AccumT>> output
+	);
+
+	struct PrecisionBenchmarkResult
+	{
+		char const * name = nullptr;
+		double milliseconds = 0.0;			// Average over the repetitions
+		double samplesPerSecond = 0.0;
+		double maxError = 0.0;				// Distance to the double/double samples
+		double meanError = 0.0;
+		int validityMismatches = 0;			// Samples that are valid in only one of the two modes
+	};
+
+	// Evaluates the curve in every precision mode plus the default float Generate and measures each against double
+	[[nodiscard]]
+	std::vector<PrecisionBenchmarkResult> BenchmarkPrecision(
+		bool interpolate,
+		std::span<glm::dvec3 const> controlPoints,
+		std::span<float const> cConstants,
+		std::span<float const> kConstants,
+		float deltaU,
+		int repetitions
+	);
+}
@@ -0,0 +1,223 @@
+#include "CinpactCurve.hpp"
+#include "CinpactSimd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define CINPACT_SIMD_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CINPACT_SIMD_NEON
+#endif
+
+namespace
+{
+	struct ScalarLanes
+	{
+		using F = float;
+		using M = bool;
+		static constexpr int Width = 1;
+
+		static F Set(float const value) { return value; }
+		static F Load(float const * ptr) { return *ptr; }
+		static void Store(float * ptr, F const value) { *ptr = value; }
+		static F Iota() { return 0.0f; }
+		static F Add(F const a, F const b) { return a + b; }
+		static F Sub(F const a, F const b) { return a - b; }
+		static F Mul(F const a, F const b) { return a * b; }
+		static F Div(F const a, F const b) { return a / b; }
+		static F Fma(F const a, F const b, F const c) { return a * b + c; }
+		static F Min(F const a, F const b) { return std::min(a, b); }
+		static F Max(F const a, F const b) { return std::max(a, b); }
+		static F Round(F const a) { return std::nearbyint(a); }
+		static M Lt(F const a, F const b) { return a < b; }
+		static M Gt(F const a, F const b) { return a > b; }
+		static M Eq(F const a, F const b) { return a == b; }
+		static M Or(M const a, M const b) { return a | b; }
+		static F Select(M const mask, F const a, F const b) { return mask ? a : b; }
+		static F Pow2(F const n)
+		{
+			auto const bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+			float result;
+			std::memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+		static F FlipSignIfOdd(F const value, F const n)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			bits ^= static_cast<uint32_t>(static_cast<int32_t>(n)) << 31;
+			float result;
+			std::memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+	};
+
+	//-----------------------------------------------------
+
+#if defined(CINPACT_SIMD_NEON)
+
+	struct NeonLanes
+	{
+		using F = float32x4_t;
+		using M = uint32x4_t;
+		static constexpr int Width = 4;
+
+		static F Set(float const value) { return vdupq_n_f32(value); }
+		static F Load(float const * ptr) { return vld1q_f32(ptr); }
+		static void Store(float * ptr, F const value) { vst1q_f32(ptr, value); }
+		static F Iota()
+		{
+			float const iota[4] { 0.0f, 1.0f, 2.0f, 3.0f };
+			return vld1q_f32(iota);
+		}
+		static F Add(F const a, F const b) { return vaddq_f32(a, b); }
+		static F Sub(F const a, F const b) { return vsubq_f32(a, b); }
+		static F Mul(F const a, F const b) { return vmulq_f32(a, b); }
+		static F Div(F const a, F const b) { return vdivq_f32(a, b); }
+		static F Fma(F const a, F const b, F const c) { return vfmaq_f32(c, a, b); }
+		static F Min(F const a, F const b) { return vminq_f32(a, b); }
+		static F Max(F const a, F const b) { return vmaxq_f32(a, b); }
+		static F Round(F const a) { return vrndnq_f32(a); }
+		static M Lt(F const a, F const b) { return vcltq_f32(a, b); }
+		static M Gt(F const a, F const b) { return vcgtq_f32(a, b); }
+		static M Eq(F const a, F const b) { return vceqq_f32(a, b); }
+		static M Or(M const a, M const b) { return vorrq_u32(a, b); }
+		static F Select(M const mask, F const a, F const b) { return vbslq_f32(mask, a, b); }
+		static F Pow2(F const n)
+		{
+			auto const exponent = vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127));
+			return vreinterpretq_f32_s32(vshlq_n_s32(exponent, 23));
+		}
+		static F FlipSignIfOdd(F const value, F const n)
+		{
+			auto const sign = vshlq_n_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(n)), 31);
+			return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(value), sign));
+		}
+	};
+
+#endif
+
+	//-----------------------------------------------------
+
+#if defined(CINPACT_SIMD_X86)
+
+	struct CpuFeatures
+	{
+		bool avx2 = false;		// Together with FMA
+		bool avx512 = false;
+	};
+
+	CpuFeatures DetectCpuFeatures()
+	{
+		CpuFeatures features{};
+#if defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return features;
+		}
+		__cpuid(info, 1);
+		bool const hasFma = (info[2] & (1 << 12)) != 0;
+		bool const hasOsxsave = (info[2] & (1 << 27)) != 0;
+		if (hasOsxsave == false)
+		{
+			return features;
+		}
+		// The os has to save the ymm and zmm registers on a context switch
+		auto const xcr0 = _xgetbv(0);
+		bool const osSavesYmm = (xcr0 & 0x6) == 0x6;
+		bool const osSavesZmm = (xcr0 & 0xe6) == 0xe6;
+		__cpuidex(info, 7, 0);
+		features.avx2 = osSavesYmm == true && hasFma == true && (info[1] & (1 << 5)) != 0;
+		features.avx512 = osSavesZmm == true && (info[1] & (1 << 16)) != 0;
+#else
+		__builtin_cpu_init();
+		features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		features.avx512 = __builtin_cpu_supports("avx512f");
+#endif
+		return features;
+	}
+
+#endif
+
+	//-----------------------------------------------------
+
+	struct Kernel
+	{
+		Cinpact::Simd::CalcWeightsFunction calcWeights = nullptr;		// Null when only the scalar lanes are available
+		char const * name = "Scalar";
+	};
+
+	Kernel DetectKernel()
+	{
+#if defined(CINPACT_SIMD_X86)
+		auto const features = DetectCpuFeatures();
+		if (features.avx512 == true)
+		{
+			return Kernel{ .calcWeights = Cinpact::Simd::CalcWeightsAvx512, .name = "AVX-512" };
+		}
+		if (features.avx2 == true)
+		{
+			return Kernel{ .calcWeights = Cinpact::Simd::CalcWeightsAvx2, .name = "AVX2" };
+		}
+#elif defined(CINPACT_SIMD_NEON)
+		return Kernel{ .calcWeights = CalcWeights<NeonLanes>, .name = "NEON" };
+#endif
+		return Kernel{};
+	}
+
+	// Decided once, the widest instruction set that the cpu supports
+	Kernel const & GetKernel()
+	{
+		static Kernel const kernel = DetectKernel();
+		return kernel;
+	}
+}
+
+//-----------------------------------------------------
+
+void Cinpact::CalcWeights(
+	bool const interpolate,
+	float const u,
+	int const first,
+	int const count,
+	float const * cConstants,
+	float const * kConstants,
+	float * outWeights
+)
+{
+	int processed = 0;
+	auto const & kernel = GetKernel();
+	if (kernel.calcWeights != nullptr)
+	{
+		processed = kernel.calcWeights(interpolate, u, first, count, cConstants, kConstants, outWeights);
+	}
+	// Remaining lanes use the same approximation so that the result does not depend on the window alignment
+	for (int j = processed; j < count; ++j)
+	{
+		outWeights[j] = CalcWeight<ScalarLanes>(
+			interpolate,
+			u,
+			static_cast<float>(first + j),
+			cConstants[first + j],
+			kConstants[first + j]
+		);
+	}
+}
+
+//-----------------------------------------------------
+
+char const * Cinpact::SimdInstructionSet()
+{
+	return GetKernel().name;
+}
+
+//-----------------------------------------------------
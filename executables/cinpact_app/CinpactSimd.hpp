@@ -0,0 +1,173 @@
+#pragma once
+
+#include <ext/scalar_constants.hpp>
+
+// Weight kernel shared by the lanes of CinpactSimd.cpp, CinpactSimdAvx2.cpp and CinpactSimdAvx512.cpp. The x86 lanes are
+// compiled in their own translation units for their instruction set and CalcWeights picks one at runtime.
+//
+// Weights are computed with polynomial approximations instead of libm.
+// exp: Cephes range reduction to [-ln2/2, ln2/2] with a degree 6 polynomial, relative error < 2e-7.
+// sin(pi * x): exact reduction to [-0.5, 0.5] followed by a degree 11 Taylor polynomial, absolute error < 1e-7.
+// 2^n is applied in two steps so that results in the denormal range match std::exp, exponents below ExpMin flush to zero.
+
+namespace Cinpact::Simd
+{
+	// Vector part of CalcWeights, writes the weights of the first multiple of the lane width control points and
+	// returns how many it wrote
+	using CalcWeightsFunction = int (*)(
+		bool interpolate,
+		float u,
+		int first,
+		int count,
+		float const * cConstants,
+		float const * kConstants,
+		float * outWeights
+	);
+
+	// Only defined on x86, the cpu has to support AVX2 and FMA
+	int CalcWeightsAvx2(
+		bool interpolate,
+		float u,
+		int first,
+		int count,
+		float const * cConstants,
+		float const * kConstants,
+		float * outWeights
+	);
+
+	// Only defined on x86, the cpu has to support AVX-512F
+	int CalcWeightsAvx512(
+		bool interpolate,
+		float u,
+		int first,
+		int count,
+		float const * cConstants,
+		float const * kConstants,
+		float * outWeights
+	);
+}
+
+// Internal linkage on purpose, every translation unit compiles its own copy for the instruction set it was included with
+namespace
+{
+	constexpr float ExpMin = -103.9f;
+	constexpr float ExpMax = 88.0f;
+	constexpr float Log2e = 1.44269504088896341f;
+	constexpr float Ln2Hi = 0.693359375f;
+	constexpr float Ln2Lo = -2.12194440e-4f;
+
+	//-----------------------------------------------------
+
+	template<typename L>
+	typename L::F Exp(typename L::F const x)
+	{
+		auto const clamped = L::Min(L::Max(x, L::Set(ExpMin)), L::Set(ExpMax));
+		auto const n = L::Round(L::Mul(clamped, L::Set(Log2e)));
+		auto r = L::Fma(n, L::Set(-Ln2Hi), clamped);
+		r = L::Fma(n, L::Set(-Ln2Lo), r);
+
+		auto p = L::Set(1.9875691500e-4f);
+		p = L::Fma(p, r, L::Set(1.3981999507e-3f));
+		p = L::Fma(p, r, L::Set(8.3334519073e-3f));
+		p = L::Fma(p, r, L::Set(4.1665795894e-2f));
+		p = L::Fma(p, r, L::Set(1.6666665459e-1f));
+		p = L::Fma(p, r, L::Set(5.0000001201e-1f));
+		p = L::Fma(p, L::Mul(r, r), L::Add(r, L::Set(1.0f)));
+
+		auto const halfN = L::Round(L::Mul(n, L::Set(0.5f)));
+		auto const result = L::Mul(L::Mul(p, L::Pow2(halfN)), L::Pow2(L::Sub(n, halfN)));
+		return L::Select(L::Lt(x, L::Set(ExpMin)), L::Set(0.0f), result);
+	}
+
+	//-----------------------------------------------------
+
+	// sin(pi * x) with x = n + f, |f| <= 0.5 and sin(pi * x) = (-1)^n * sin(pi * f)
+	template<typename L>
+	typename L::F SinPi(typename L::F const x)
+	{
+		auto const n = L::Round(x);
+		auto const angle = L::Mul(L::Sub(x, n), L::Set(glm::pi<float>()));
+		auto const angle2 = L::Mul(angle, angle);
+
+		auto p = L::Set(-1.0f / 39916800.0f);
+		p = L::Fma(p, angle2, L::Set(1.0f / 362880.0f));
+		p = L::Fma(p, angle2, L::Set(-1.0f / 5040.0f));
+		p = L::Fma(p, angle2, L::Set(1.0f / 120.0f));
+		p = L::Fma(p, angle2, L::Set(-1.0f / 6.0f));
+		p = L::Fma(L::Mul(p, angle2), angle, angle);
+
+		return L::FlipSignIfOdd(p, n);
+	}
+
+	//-----------------------------------------------------
+
+	// Mirrors CalcA and CalcI, the branches are replaced with masks
+	template<typename L>
+	typename L::F CalcWeight(
+		bool const interpolate,
+		typename L::F const u,
+		typename L::F const i,
+		typename L::F const c,
+		typename L::F const k
+	)
+	{
+		auto const zero = L::Set(0.0f);
+		auto const epsilon = L::Set(glm::epsilon<float>());
+
+		auto const isOutside = L::Or(
+			L::Lt(u, L::Add(L::Sub(zero, c), i)),
+			L::Gt(u, L::Add(c, i))
+		);
+
+		auto const uMinI = L::Sub(u, i);
+		auto const uMinISquare = L::Mul(uMinI, uMinI);
+
+		auto bottom = L::Sub(L::Mul(c, c), uMinISquare);
+		bottom = L::Select(L::Eq(bottom, zero), L::Add(bottom, epsilon), bottom);
+
+		auto const top = L::Mul(L::Sub(zero, k), uMinISquare);
+		auto weight = L::Select(isOutside, zero, Exp<L>(L::Div(top, bottom)));
+
+		if (interpolate == true)
+		{
+			auto bottomI = L::Mul(uMinI, L::Set(glm::pi<float>()));
+			bottomI = L::Select(L::Eq(bottomI, zero), L::Add(bottomI, epsilon), bottomI);
+			// sin(pi x) / (pi x) is 1 at x = 0
+			auto const sinc = L::Select(L::Eq(uMinI, zero), L::Set(1.0f), L::Div(SinPi<L>(uMinI), bottomI));
+			weight = L::Mul(weight, sinc);
+		}
+
+		return weight;
+	}
+
+	//-----------------------------------------------------
+
+	template<typename L>
+	int CalcWeights(
+		bool const interpolate,
+		float const u,
+		int const first,
+		int const count,
+		float const * cConstants,
+		float const * kConstants,
+		float * outWeights
+	)
+	{
+		auto const uVec = L::Set(u);
+		auto const iota = L::Iota();
+		int j = 0;
+		for (; j + L::Width <= count; j += L::Width)
+		{
+			auto const i = L::Add(L::Set(static_cast<float>(first + j)), iota);
+			auto const weight = CalcWeight<L>(
+				interpolate,
+				uVec,
+				i,
+				L::Load(cConstants + first + j),
+				L::Load(kConstants + first + j)
+			);
+			L::Store(outWeights + j, weight);
+		}
+		return j;
+	}
+}
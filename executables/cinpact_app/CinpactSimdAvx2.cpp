@@ -0,0 +1,78 @@
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <ext/scalar_constants.hpp>
+
+// Only the code below is compiled for AVX2. The inline functions of the headers above keep the baseline instruction set,
+// so the linker never picks an AVX2 copy of them for the rest of the program. MSVC emits the intrinsics without flags
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#include "CinpactSimd.hpp"
+
+namespace
+{
+	struct Avx2Lanes
+	{
+		using F = __m256;
+		using M = __m256;
+		static constexpr int Width = 8;
+
+		static F Set(float const value) { return _mm256_set1_ps(value); }
+		static F Load(float const * ptr) { return _mm256_loadu_ps(ptr); }
+		static void Store(float * ptr, F const value) { _mm256_storeu_ps(ptr, value); }
+		static F Iota() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+		static F Add(F const a, F const b) { return _mm256_add_ps(a, b); }
+		static F Sub(F const a, F const b) { return _mm256_sub_ps(a, b); }
+		static F Mul(F const a, F const b) { return _mm256_mul_ps(a, b); }
+		static F Div(F const a, F const b) { return _mm256_div_ps(a, b); }
+		static F Fma(F const a, F const b, F const c) { return _mm256_fmadd_ps(a, b, c); }
+		static F Min(F const a, F const b) { return _mm256_min_ps(a, b); }
+		static F Max(F const a, F const b) { return _mm256_max_ps(a, b); }
+		static F Round(F const a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static M Lt(F const a, F const b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static M Gt(F const a, F const b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static M Eq(F const a, F const b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		static M Or(M const a, M const b) { return _mm256_or_ps(a, b); }
+		static F Select(M const mask, F const a, F const b) { return _mm256_blendv_ps(b, a, mask); }
+		static F Pow2(F const n)
+		{
+			auto const exponent = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+			return _mm256_castsi256_ps(_mm256_slli_epi32(exponent, 23));
+		}
+		static F FlipSignIfOdd(F const value, F const n)
+		{
+			auto const sign = _mm256_slli_epi32(_mm256_cvtps_epi32(n), 31);
+			return _mm256_xor_ps(value, _mm256_castsi256_ps(sign));
+		}
+	};
+}
+
+//-----------------------------------------------------
+
+int Cinpact::Simd::CalcWeightsAvx2(
+	bool const interpolate,
+	float const u,
+	int const first,
+	int const count,
+	float const * cConstants,
+	float const * kConstants,
+	float * outWeights
+)
+{
+	return CalcWeights<Avx2Lanes>(interpolate, u, first, count, cConstants, kConstants, outWeights);
+}
+
+//-----------------------------------------------------
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
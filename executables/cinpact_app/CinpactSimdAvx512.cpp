@@ -0,0 +1,77 @@
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+#include <ext/scalar_constants.hpp>
+
+// Only the code below is compiled for AVX-512, see CinpactSimdAvx2.cpp
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#include "CinpactSimd.hpp"
+
+namespace
+{
+	struct Avx512Lanes
+	{
+		using F = __m512;
+		using M = __mmask16;
+		static constexpr int Width = 16;
+
+		static F Set(float const value) { return _mm512_set1_ps(value); }
+		static F Load(float const * ptr) { return _mm512_loadu_ps(ptr); }
+		static void Store(float * ptr, F const value) { _mm512_storeu_ps(ptr, value); }
+		static F Iota() { return _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+		static F Add(F const a, F const b) { return _mm512_add_ps(a, b); }
+		static F Sub(F const a, F const b) { return _mm512_sub_ps(a, b); }
+		static F Mul(F const a, F const b) { return _mm512_mul_ps(a, b); }
+		static F Div(F const a, F const b) { return _mm512_div_ps(a, b); }
+		static F Fma(F const a, F const b, F const c) { return _mm512_fmadd_ps(a, b, c); }
+		static F Min(F const a, F const b) { return _mm512_min_ps(a, b); }
+		static F Max(F const a, F const b) { return _mm512_max_ps(a, b); }
+		static F Round(F const a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static M Lt(F const a, F const b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		static M Gt(F const a, F const b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+		static M Eq(F const a, F const b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+		static M Or(M const a, M const b) { return static_cast<M>(a | b); }
+		static F Select(M const mask, F const a, F const b) { return _mm512_mask_blend_ps(mask, b, a); }
+		static F Pow2(F const n)
+		{
+			auto const exponent = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+			return _mm512_castsi512_ps(_mm512_slli_epi32(exponent, 23));
+		}
+		static F FlipSignIfOdd(F const value, F const n)
+		{
+			auto const sign = _mm512_slli_epi32(_mm512_cvtps_epi32(n), 31);
+			return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(value), sign));
+		}
+	};
+}
+
+//-----------------------------------------------------
+
+int Cinpact::Simd::CalcWeightsAvx512(
+	bool const interpolate,
+	float const u,
+	int const first,
+	int const count,
+	float const * cConstants,
+	float const * kConstants,
+	float * outWeights
+)
+{
+	return CalcWeights<Avx512Lanes>(interpolate, u, first, count, cConstants, kConstants, outWeights);
+}
+
+//-----------------------------------------------------
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+#include "CinpactSlotMap.hpp"
+
+#include "BedrockAssert.hpp"
+
+//-----------------------------------------------------
+
+Cinpact::Handle Cinpact::SlotMap::Insert()
+{
+	uint32_t slotIdx;
+	if (_freeSlots.empty() == false)
+	{
+		slotIdx = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	else
+	{
+		slotIdx = static_cast<uint32_t>(_slots.size());
+		_slots.emplace_back();
+	}
+
+	auto & slot = _slots[slotIdx];
+	MFA_ASSERT(slot.index < 0);
+	slot.index = Count();
+	_slotOfIndex.emplace_back(slotIdx);
+
+	return Handle{.slot = slotIdx, .generation = slot.generation};
+}
+
+//-----------------------------------------------------
+
+int Cinpact::SlotMap::Remove(Handle const handle)
+{
+	auto const index = IndexOf(handle);
+	MFA_ASSERT(index >= 0);
+
+	auto & slot = _slots[handle.slot];
+	slot.index = -1;
+	++slot.generation;
+	_freeSlots.emplace_back(handle.slot);
+
+	// Keeping the order of the curve means shifting the tail, the columns are erased from in the same way
+	_slotOfIndex.erase(_slotOfIndex.begin() + index);
+	for (int i = index; i < Count(); ++i)
+	{
+		_slots[_slotOfIndex[i]].index = i;
+	}
+
+	return index;
+}
+
+//-----------------------------------------------------
+
+void Cinpact::SlotMap::Clear()
+{
+	for (auto const slotIdx : _slotOfIndex)
+	{
+		auto & slot = _slots[slotIdx];
+		slot.index = -1;
+		++slot.generation;
+		_freeSlots.emplace_back(slotIdx);
+	}
+	_slotOfIndex.clear();
+}
+
+//-----------------------------------------------------
+
+void Cinpact::SlotMap::Reset(int const count)
+{
+	MFA_ASSERT(count >= 0);
+	Clear();
+	_slotOfIndex.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		Insert();
+	}
+}
+
+//-----------------------------------------------------
+
+int Cinpact::SlotMap::IndexOf(Handle const handle) const
+{
+	if (handle.slot >= _slots.size())
+	{
+		return -1;
+	}
+	auto const & slot = _slots[handle.slot];
+	return slot.generation == handle.generation ? slot.index : -1;
+}
+
+//-----------------------------------------------------
+
+Cinpact::Handle Cinpact::SlotMap::HandleOf(int const index) const
+{
+	MFA_ASSERT(index >= 0 && index < Count());
+	auto const slotIdx = _slotOfIndex[index];
+	return Handle{.slot = slotIdx, .generation = _slots[slotIdx].generation};
+}
+
+//-----------------------------------------------------
+
+int Cinpact::SlotMap::Count() const
+{
+	return static_cast<int>(_slotOfIndex.size());
+}
+
+//-----------------------------------------------------
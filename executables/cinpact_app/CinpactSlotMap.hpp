@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Cinpact
+{
+	// Stays valid until the item it refers to is removed, no matter how the other items move
+	struct Handle
+	{
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+		uint32_t slot = InvalidSlot;
+		uint32_t generation = 0;
+
+		bool operator==(Handle const & other) const = default;
+	};
+
+	// Hands out handles to the items of columns that are stored outside of it. The columns keep the order of the
+	// curve, so the slot map only tracks which index each handle currently refers to. A slot is reused after its item
+	// is removed, its generation tells old handles apart from the new item
+	class SlotMap
+	{
+	public:
+
+		// The new item goes after the last one, its index is Count() before the call
+		Handle Insert();
+
+		// Returns the index the item had, the items after it move down by one like they do in the columns
+		int Remove(Handle handle);
+
+		// Handles that were handed out before are invalid afterwards
+		void Clear();
+
+		// Clears the map and inserts count items
+		void Reset(int count);
+
+		// Returns -1 if the item was removed
+		[[nodiscard]]
+		int IndexOf(Handle handle) const;
+
+		[[nodiscard]]
+		Handle HandleOf(int index) const;
+
+		[[nodiscard]]
+		int Count() const;
+
+	private:
+
+		struct Slot
+		{
+			int index = -1;						// -1 while the slot is free
+			uint32_t generation = 0;
+		};
+
+		std::vector<Slot> _slots{};
+		std::vector<uint32_t> _freeSlots{};
+		std::vector<uint32_t> _slotOfIndex{};
+	};
+}
@@ -0,0 +1,207 @@
+#include "CinpactStream.hpp"
+
+#include "CinpactCurve.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+//-----------------------------------------------------
+
+// Cinpact::SampleCount as long as its result fits in an int, the same formula in double precision for longer curves
+static int64_t StreamSampleCount(int64_t const controlPointCount, float const deltaU)
+{
+	auto const stepCount = std::ceil((static_cast<double>(controlPointCount) - 1.0 - 2.0 * deltaU) / deltaU);
+	if (stepCount < static_cast<double>(std::numeric_limits<int>::max() / 2))
+	{
+		return Cinpact::SampleCount(static_cast<int>(controlPointCount), deltaU);
+	}
+	return static_cast<int64_t>(stepCount);
+}
+
+//-----------------------------------------------------
+
+Cinpact::StreamEvaluator::StreamEvaluator(
+	bool const interpolate,
+	float const deltaU,
+	float const maxC,
+	Sink sink,
+	int const chunkSampleCount
+)
+	: _interpolate(interpolate)
+	, _deltaU(deltaU)
+	, _maxC(maxC)
+	, _sink(std::move(sink))
+	, _chunkSampleCount(chunkSampleCount)
+{
+	MFA_ASSERT(deltaU > 0.0f);
+	MFA_ASSERT(maxC >= 0.0f);
+	MFA_ASSERT(chunkSampleCount > 0);
+	MFA_ASSERT(_sink != nullptr);
+}
+
+//-----------------------------------------------------
+
+void Cinpact::StreamEvaluator::Push(
+	std::span<glm::vec3 const> const controlPoints,
+	std::span<float const> const cConstants,
+	std::span<float const> const kConstants
+)
+{
+	MFA_ASSERT(cConstants.size() == controlPoints.size());
+	MFA_ASSERT(kConstants.size() == controlPoints.size());
+
+	MFA_ASSERT(std::all_of(cConstants.begin(), cConstants.end(), [this](float const c){ return c <= _maxC; }));
+
+	_controlPoints.insert(_controlPoints.end(), controlPoints.begin(), controlPoints.end());
+	_cConstants.insert(_cConstants.end(), cConstants.begin(), cConstants.end());
+	_kConstants.insert(_kConstants.end(), kConstants.begin(), kConstants.end());
+
+	// A sample is complete once every control point within maxC of it has arrived. One more point of margin covers the
+	// rounding of u, which would otherwise take a missing point for the end of the curve
+	auto const pointCount = ControlPointCount();
+	auto const completeCount = static_cast<int64_t>(std::floor((static_cast<double>(pointCount) - 2.0 - _maxC) / _deltaU));
+	auto const lastSample = std::min(StreamSampleCount(pointCount, _deltaU), completeCount);
+	if (lastSample > _nextSample)
+	{
+		Evaluate(lastSample);
+	}
+}
+
+//-----------------------------------------------------
+
+int64_t Cinpact::StreamEvaluator::Finish()
+{
+	Evaluate(StreamSampleCount(ControlPointCount(), _deltaU));
+
+	auto const validSampleCount = _validSampleCount;
+
+	_controlPoints.clear();
+	_cConstants.clear();
+	_kConstants.clear();
+	_firstPoint = 0;
+	_nextSample = 0;
+	_validSampleCount = 0;
+
+	return validSampleCount;
+}
+
+//-----------------------------------------------------
+
+int64_t Cinpact::StreamEvaluator::Run(Reader const & reader, int const chunkPointCount)
+{
+	MFA_ASSERT(chunkPointCount > 0);
+
+	std::vector<glm::vec3> controlPoints(chunkPointCount);
+	std::vector<float> cConstants(chunkPointCount);
+	std::vector<float> kConstants(chunkPointCount);
+
+	while (true)
+	{
+		auto const readCount = reader(controlPoints, cConstants, kConstants);
+		MFA_ASSERT(readCount >= 0 && readCount <= chunkPointCount);
+		if (readCount <= 0)
+		{
+			break;
+		}
+		Push(
+			std::span{controlPoints}.first(readCount),
+			std::span{cConstants}.first(readCount),
+			std::span{kConstants}.first(readCount)
+		);
+	}
+
+	return Finish();
+}
+
+//-----------------------------------------------------
+
+int64_t Cinpact::StreamEvaluator::ControlPointCount() const
+{
+	return _firstPoint + static_cast<int64_t>(_controlPoints.size());
+}
+
+//-----------------------------------------------------
+
+int64_t Cinpact::StreamEvaluator::ValidSampleCount() const
+{
+	return _validSampleCount;
+}
+
+//-----------------------------------------------------
+
+int Cinpact::StreamEvaluator::HeldControlPointCount() const
+{
+	return static_cast<int>(_controlPoints.size());
+}
+
+//-----------------------------------------------------
+
+void Cinpact::StreamEvaluator::Evaluate(int64_t const lastSample)
+{
+	auto const heldCount = static_cast<int64_t>(_controlPoints.size());
+
+	// First control point that can reach sample k, with one point of margin for the rounding of u
+	auto const firstPointOf = [this](int64_t const k)
+	{
+		auto const u = static_cast<double>(k + 1) * _deltaU;
+		return std::max(_firstPoint, static_cast<int64_t>(std::floor(u - _maxC)) - 1);
+	};
+
+	while (_nextSample < lastSample)
+	{
+		auto const sampleCount = static_cast<int>(std::min<int64_t>(_chunkSampleCount, lastSample - _nextSample));
+
+		// Only the control points that reach this chunk are passed on, which keeps the cost per chunk independent of
+		// the size of the pushed chunks
+		auto const lastU = static_cast<double>(_nextSample + sampleCount) * _deltaU;
+		auto const windowFirst = firstPointOf(_nextSample) - _firstPoint;
+		auto const windowLast = std::min(heldCount, static_cast<int64_t>(std::ceil(lastU + _maxC)) + 2 - _firstPoint);
+		auto const windowSize = static_cast<size_t>(windowLast - windowFirst);
+
+		_samples.resize(sampleCount);
+		_isValid.resize(sampleCount);
+		GenerateWindow(
+			_interpolate,
+			std::span<glm::vec3 const>{_controlPoints}.subspan(windowFirst, windowSize),
+			std::span<float const>{_cConstants}.subspan(windowFirst, windowSize),
+			std::span<float const>{_kConstants}.subspan(windowFirst, windowSize),
+			_deltaU,
+			_firstPoint + windowFirst,
+			_nextSample,
+			_samples,
+			_isValid
+		);
+
+		int validCount = 0;
+		for (int j = 0; j < sampleCount; ++j)
+		{
+			if (_isValid[j] != 0)
+			{
+				_samples[validCount++] = _samples[j];
+			}
+		}
+		if (validCount > 0)
+		{
+			_sink(std::span<glm::vec3 const>{_samples.data(), static_cast<size_t>(validCount)});
+		}
+
+		_nextSample += sampleCount;
+		_validSampleCount += validCount;
+	}
+
+	// Everything in front of the halo of the next sample is no longer needed
+	auto const dropCount = std::min(heldCount, firstPointOf(_nextSample) - _firstPoint);
+	if (dropCount > 0)
+	{
+		_controlPoints.erase(_controlPoints.begin(), _controlPoints.begin() + dropCount);
+		_cConstants.erase(_cConstants.begin(), _cConstants.begin() + dropCount);
+		_kConstants.erase(_kConstants.begin(), _kConstants.begin() + dropCount);
+		_firstPoint += dropCount;
+	}
+}
+
+//-----------------------------------------------------
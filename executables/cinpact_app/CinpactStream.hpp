@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vec3.hpp>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Cinpact
+{
+	// Evaluates a curve whose control points arrive in chunks, for curves that do not fit in memory. Because of compact
+	// support a sample only depends on the control points within maxC of it, so only a halo of the previous chunks is
+	// kept and samples are passed to the sink in the order of u as soon as all of their control points have arrived
+	class StreamEvaluator
+	{
+	public:
+
+		// Receives the next valid samples, the span is only valid during the call
+		using Sink = std::function<void(std::span<glm::vec3 const> samples)>;
+
+		// Writes the next control points to the spans and returns how many were written, 0 at the end of the curve
+		using Reader = std::function<int(
+			std::span<glm::vec3> controlPoints,
+			std::span<float> cConstants,
+			std::span<float> kConstants
+		)>;
+
+		static constexpr int DefaultChunkSampleCount = 1 << 16;
+
+		// Every control point must have a c of at most maxC. The sink is called with at most chunkSampleCount samples
+		explicit StreamEvaluator(
+			bool interpolate,
+			float deltaU,
+			float maxC,
+			Sink sink,
+			int chunkSampleCount = DefaultChunkSampleCount
+		);
+
+		// Appends control points to the end of the curve
+		void Push(
+			std::span<glm::vec3 const> controlPoints,
+			std::span<float const> cConstants,
+			std::span<float const> kConstants
+		);
+
+		// Evaluates the samples that are left at the end of the curve and returns the number of valid samples of the
+		// curve. The evaluator starts a new curve afterwards
+		int64_t Finish();
+
+		// Pushes chunkPointCount control points at a time from reader until it returns 0, then calls Finish
+		int64_t Run(Reader const & reader, int chunkPointCount);
+
+		[[nodiscard]]
+		int64_t ControlPointCount() const;
+
+		// Number of valid samples passed to the sink since the current curve started
+		[[nodiscard]]
+		int64_t ValidSampleCount() const;
+
+		// Number of control points that are held, at most the last chunk and its halo
+		[[nodiscard]]
+		int HeldControlPointCount() const;
+
+	private:
+
+		// Evaluates samples [_nextSample, lastSample) and drops the control points that no later sample needs
+		void Evaluate(int64_t lastSample);
+
+		bool _interpolate = true;
+		float _deltaU = 0.0f;
+		float _maxC = 0.0f;
+		Sink _sink{};
+		int _chunkSampleCount = DefaultChunkSampleCount;
+
+		// Control points [_firstPoint, _firstPoint + _controlPoints.size()) of the curve
+		std::vector<glm::vec3> _controlPoints{};
+		std::vector<float> _cConstants{};
+		std::vector<float> _kConstants{};
+		int64_t _firstPoint = 0;
+
+		int64_t _nextSample = 0;
+		int64_t _validSampleCount = 0;
+
+		std::vector<glm::vec3> _samples{};
+		std::vector<uint8_t> _isValid{};
+	};
+}
@@ -0,0 +1,412 @@
+#include "CinpactCurve.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures how Cinpact::Generate scales. Every sweep varies one parameter of the base configuration and runs it
+// with each thread count, the results are written as json so that runs can be compared across commits and machines.
+
+//-----------------------------------------------------
+
+struct Options
+{
+    std::string outputPath{};           // Empty writes to stdout
+    int repetitions = 5;
+    int maxPointCount = 1'000'000;
+    std::vector<int> threadCounts{};    // Empty picks powers of two up to the hardware concurrency
+};
+
+struct Configuration
+{
+    char const * sweep = "";
+    int pointCount = 1'000;
+    float c = 10.0f;
+    float k = 10.0f;
+    bool interpolate = true;
+    float deltaU = 1e-1f;               // Coarser than the app default so that a million points fit in memory
+};
+
+struct Result
+{
+    Configuration configuration{};
+    int threadCount = 0;
+    int sampleCount = 0;
+    int validCount = 0;
+    bool usesBasisTable = false;
+    double medianMilliseconds = 0.0;
+    double minMilliseconds = 0.0;
+    double samplesPerSecond = 0.0;
+    double nsPerSample = 0.0;
+    // Speedup over one thread divided by the thread count
+    double parallelEfficiency = 0.0;
+};
+
+//-----------------------------------------------------
+
+static void PrintUsage()
+{
+    std::printf(
+        "Usage: cinpact_bench [options]\n"
+        "  -o, --output <path>       Write the json report to path instead of stdout\n"
+        "  -r, --repetitions <count> Timed runs per configuration, the median is reported\n"
+        "  -p, --max-points <count>  Largest control point count of the point count sweep\n"
+        "  -t, --threads <list>      Comma separated thread counts, for example 1,2,4\n"
+    );
+}
+
+//-----------------------------------------------------
+
+static bool ParseThreadCounts(char const * value, std::vector<int> & outThreadCounts)
+{
+    outThreadCounts.clear();
+    while (*value != '\0')
+    {
+        char * end = nullptr;
+        auto const threadCount = static_cast<int>(std::strtol(value, &end, 10));
+        if (end == value || threadCount <= 0)
+        {
+            return false;
+        }
+        outThreadCounts.emplace_back(threadCount);
+        value = *end == ',' ? end + 1 : end;
+    }
+    return outThreadCounts.empty() == false;
+}
+
+//-----------------------------------------------------
+
+static bool ParseOptions(int const argc, char ** argv, Options & outOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        auto const isOption = [&](char const * shortName, char const * longName)
+        {
+            return std::strcmp(argv[i], shortName) == 0 || std::strcmp(argv[i], longName) == 0;
+        };
+        auto const nextValue = [&]() -> char const *
+        {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (isOption("-o", "--output"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.outputPath = value;
+        }
+        else if (isOption("-r", "--repetitions"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.repetitions = std::max(1, std::atoi(value));
+        }
+        else if (isOption("-p", "--max-points"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.maxPointCount = std::max(10, std::atoi(value));
+        }
+        else if (isOption("-t", "--threads"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            if (ParseThreadCounts(value, outOptions.threadCounts) == false)
+            {
+                std::fprintf(stderr, "Invalid thread counts %s\n", value);
+                return false;
+            }
+        }
+        else
+        {
+            if (isOption("-h", "--help") == false)
+            {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------
+
+static std::vector<int> DefaultThreadCounts()
+{
+#ifdef _OPENMP
+    auto const hardwareConcurrency = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+#else
+    // Generate runs on the calling thread only
+    auto const hardwareConcurrency = 1;
+#endif
+
+    std::vector<int> threadCounts{};
+    for (int threadCount = 1; threadCount < hardwareConcurrency; threadCount *= 2)
+    {
+        threadCounts.emplace_back(threadCount);
+    }
+    threadCounts.emplace_back(hardwareConcurrency);
+    // JobSystem uses 80% of the hardware threads
+    threadCounts.emplace_back(std::max(1, static_cast<int>(static_cast<float>(hardwareConcurrency) * 0.8f)));
+
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    return threadCounts;
+}
+
+//-----------------------------------------------------
+
+static std::vector<Configuration> MakeConfigurations(int const maxPointCount)
+{
+    Configuration const base{};
+    std::vector<Configuration> configurations{};
+
+    for (int pointCount = 10; pointCount <= maxPointCount; pointCount *= 10)
+    {
+        auto & configuration = configurations.emplace_back(base);
+        configuration.sweep = "pointCount";
+        configuration.pointCount = pointCount;
+    }
+    for (auto const c : {1.0f, 2.0f, 5.0f, 10.0f, 20.0f, 50.0f})
+    {
+        auto & configuration = configurations.emplace_back(base);
+        configuration.sweep = "c";
+        configuration.c = c;
+    }
+    for (auto const interpolate : {false, true})
+    {
+        auto & configuration = configurations.emplace_back(base);
+        configuration.sweep = "interpolate";
+        configuration.interpolate = interpolate;
+    }
+    // 3e-2 is not a whole number of samples per unit and skips the basis table
+    for (auto const deltaU : {1e-1f, 3e-2f, 1e-2f, 1e-3f})
+    {
+        auto & configuration = configurations.emplace_back(base);
+        configuration.sweep = "deltaU";
+        configuration.deltaU = deltaU;
+    }
+    return configurations;
+}
+
+//-----------------------------------------------------
+
+static std::vector<Result> RunConfiguration(
+    Configuration const & configuration,
+    std::vector<int> const & threadCounts,
+    int const repetitions
+)
+{
+    std::mt19937 random{1234};
+    std::uniform_real_distribution<float> step{-1.0f, 1.0f};
+
+    std::vector<glm::vec3> controlPoints(configuration.pointCount);
+    glm::vec3 position{};
+    for (auto & controlPoint : controlPoints)
+    {
+        position += glm::vec3{step(random), step(random), step(random)};
+        controlPoint = position;
+    }
+    std::vector<float> const cConstants(configuration.pointCount, configuration.c);
+    std::vector<float> const kConstants(configuration.pointCount, configuration.k);
+
+    auto const sampleCount = Cinpact::SampleCount(configuration.pointCount, configuration.deltaU);
+    std::vector<glm::vec3> samples(sampleCount);
+
+    std::vector<Result> results{};
+    std::vector<double> durations(repetitions);
+    for (auto const threadCount : threadCounts)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(threadCount);
+#endif
+
+        auto & result = results.emplace_back();
+        result.configuration = configuration;
+        result.threadCount = threadCount;
+        result.sampleCount = sampleCount;
+        result.usesBasisTable = Cinpact::UsesBasisTable(cConstants, kConstants, configuration.deltaU);
+
+        auto const generate = [&]()
+        {
+            return Cinpact::Generate(
+                configuration.interpolate, controlPoints, cConstants, kConstants, configuration.deltaU, samples
+            );
+        };
+
+        // Warm up, builds the basis table and the thread pool
+        result.validCount = generate();
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto const startTime = std::chrono::steady_clock::now();
+            generate();
+            durations[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        }
+        std::sort(durations.begin(), durations.end());
+
+        result.medianMilliseconds = durations[durations.size() / 2];
+        result.minMilliseconds = durations.front();
+        if (result.medianMilliseconds > 0.0)
+        {
+            result.samplesPerSecond = sampleCount / (result.medianMilliseconds * 1e-3);
+        }
+        if (sampleCount > 0)
+        {
+            result.nsPerSample = result.medianMilliseconds * 1e6 / sampleCount;
+        }
+
+        std::fprintf(
+            stderr,
+            "%-11s points %7d, c %4.1f, interpolate %d, deltaU %g, threads %2d: %9.3f ms, %.3g samples/s\n",
+            configuration.sweep,
+            configuration.pointCount,
+            configuration.c,
+            configuration.interpolate == true ? 1 : 0,
+            configuration.deltaU,
+            threadCount,
+            result.medianMilliseconds,
+            result.samplesPerSecond
+        );
+    }
+
+    // Efficiency is relative to the single thread run, or to the smallest thread count that was measured
+    auto const & reference = results.front();
+    for (auto & result : results)
+    {
+        if (result.samplesPerSecond > 0.0 && reference.samplesPerSecond > 0.0)
+        {
+            auto const speedup = result.samplesPerSecond / reference.samplesPerSecond;
+            result.parallelEfficiency = speedup * reference.threadCount / result.threadCount;
+        }
+    }
+
+    return results;
+}
+
+//-----------------------------------------------------
+
+static void WriteReport(
+    std::FILE * file,
+    std::vector<int> const & threadCounts,
+    int const repetitions,
+    std::vector<Result> const & results
+)
+{
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "    \"simd\": \"%s\",\n", Cinpact::SimdInstructionSet());
+    std::fprintf(file, "    \"hardwareConcurrency\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "    \"repetitions\": %d,\n", repetitions);
+    std::fprintf(file, "    \"threadCounts\": [");
+    for (size_t i = 0; i < threadCounts.size(); ++i)
+    {
+        std::fprintf(file, "%s%d", i > 0 ? ", " : "", threadCounts[i]);
+    }
+    std::fprintf(file, "],\n");
+    std::fprintf(file, "    \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        auto const & result = results[i];
+        auto const & configuration = result.configuration;
+        std::fprintf(
+            file,
+            "        {\"sweep\": \"%s\", \"pointCount\": %d, \"c\": %g, \"k\": %g, \"interpolate\": %s, \"deltaU\": %g, "
+            "\"threads\": %d, \"samples\": %d, \"validSamples\": %d, \"basisTable\": %s, "
+            "\"medianMs\": %.6f, \"minMs\": %.6f, \"samplesPerSecond\": %.6g, \"nsPerSample\": %.6g, "
+            "\"parallelEfficiency\": %.4f}%s\n",
+            configuration.sweep,
+            configuration.pointCount,
+            configuration.c,
+            configuration.k,
+            configuration.interpolate == true ? "true" : "false",
+            configuration.deltaU,
+            result.threadCount,
+            result.sampleCount,
+            result.validCount,
+            result.usesBasisTable == true ? "true" : "false",
+            result.medianMilliseconds,
+            result.minMilliseconds,
+            result.samplesPerSecond,
+            result.nsPerSample,
+            result.parallelEfficiency,
+            i + 1 < results.size() ? "," : ""
+        );
+    }
+    std::fprintf(file, "    ]\n");
+    std::fprintf(file, "}\n");
+}
+
+//-----------------------------------------------------
+
+int main(int const argc, char ** argv)
+{
+    Options options{};
+    if (ParseOptions(argc, argv, options) == false)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+#ifndef _OPENMP
+    if (options.threadCounts.empty() == false)
+    {
+        std::fprintf(stderr, "Built without OpenMP, --threads is ignored\n");
+        options.threadCounts.clear();
+    }
+#endif
+
+    auto threadCounts = options.threadCounts.empty() == true ? DefaultThreadCounts() : options.threadCounts;
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    std::vector<Result> results{};
+    for (auto const & configuration : MakeConfigurations(options.maxPointCount))
+    {
+        auto configurationResults = RunConfiguration(configuration, threadCounts, options.repetitions);
+        results.insert(results.end(), configurationResults.begin(), configurationResults.end());
+    }
+
+    auto * file = stdout;
+    if (options.outputPath.empty() == false)
+    {
+        file = std::fopen(options.outputPath.c_str(), "w");
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "Failed to open %s\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+    WriteReport(file, threadCounts, options.repetitions, results);
+    if (file != stdout)
+    {
+        std::fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,360 @@
+#include "CinpactCurve.hpp"
+#include "CinpactFile.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Evaluates a curve without a window or a gpu, for benchmarks and regression runs on build machines.
+//
+// Input file, one entry per line, # starts a comment:
+//   deltaU 0.01
+//   interpolate 1
+//   point x y z c k
+// Input files that end in .cpb are binary curve files (see CinpactFile.hpp), their arrays are evaluated in place.
+// Output file, one valid sample per line: x y z
+
+//-----------------------------------------------------
+
+struct Options
+{
+    std::string inputPath{};
+    std::string outputPath{};
+    std::string binaryOutputPath{};
+    int threadCount = 0;                // 0 keeps the OpenMP default
+    int repetitions = 1;
+    bool printTiming = false;
+};
+
+struct CurveInput
+{
+    bool interpolate = true;
+    float deltaU = 1e-2f;
+    std::vector<glm::vec3> controlPoints{};
+    std::vector<float> cConstants{};
+    std::vector<float> kConstants{};
+};
+
+//-----------------------------------------------------
+
+static int MaxThreadCount()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+//-----------------------------------------------------
+
+static void PrintUsage()
+{
+    std::printf(
+        "Usage: cinpact_cli <input> [options]\n"
+        "  -o, --output <path>       Write the samples to path\n"
+        "  -b, --write-binary <path> Write the control points to path as a binary curve file\n"
+        "  -t, --threads <count>     Number of OpenMP threads\n"
+        "  -r, --repetitions <count> Evaluate the curve count times\n"
+        "      --timing              Print the evaluation time\n"
+    );
+}
+
+//-----------------------------------------------------
+
+static bool ParseOptions(int const argc, char ** argv, Options & outOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        auto const isOption = [&](char const * shortName, char const * longName)
+        {
+            return (shortName != nullptr && std::strcmp(argv[i], shortName) == 0) || std::strcmp(argv[i], longName) == 0;
+        };
+        auto const nextValue = [&]() -> char const *
+        {
+            if (i + 1 >= argc)
+            {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (isOption("-o", "--output"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.outputPath = value;
+        }
+        else if (isOption("-b", "--write-binary"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.binaryOutputPath = value;
+        }
+        else if (isOption("-t", "--threads"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.threadCount = std::atoi(value);
+        }
+        else if (isOption("-r", "--repetitions"))
+        {
+            auto const value = nextValue();
+            if (value == nullptr)
+            {
+                return false;
+            }
+            outOptions.repetitions = std::max(1, std::atoi(value));
+        }
+        else if (isOption(nullptr, "--timing"))
+        {
+            outOptions.printTiming = true;
+        }
+        else if (isOption("-h", "--help"))
+        {
+            return false;
+        }
+        else if (argv[i][0] != '-' && outOptions.inputPath.empty() == true)
+        {
+            outOptions.inputPath = argv[i];
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    return outOptions.inputPath.empty() == false;
+}
+
+//-----------------------------------------------------
+
+static bool ReadInput(std::string const & path, CurveInput & outInput)
+{
+    std::ifstream file{path};
+    if (file.is_open() == false)
+    {
+        std::fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        auto const commentBegin = line.find('#');
+        if (commentBegin != std::string::npos)
+        {
+            line.resize(commentBegin);
+        }
+
+        std::istringstream stream{line};
+        std::string key;
+        if (!(stream >> key))
+        {
+            continue;
+        }
+
+        bool isValid = true;
+        if (key == "deltaU")
+        {
+            isValid = static_cast<bool>(stream >> outInput.deltaU) && outInput.deltaU > 0.0f;
+        }
+        else if (key == "interpolate")
+        {
+            int interpolate;
+            isValid = static_cast<bool>(stream >> interpolate);
+            outInput.interpolate = interpolate != 0;
+        }
+        else if (key == "point")
+        {
+            glm::vec3 position;
+            float c, k;
+            isValid = static_cast<bool>(stream >> position.x >> position.y >> position.z >> c >> k);
+            outInput.controlPoints.emplace_back(position);
+            outInput.cConstants.emplace_back(c);
+            outInput.kConstants.emplace_back(k);
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if (isValid == false)
+        {
+            std::fprintf(stderr, "%s:%d: Invalid line\n", path.c_str(), lineNumber);
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------
+
+static bool WriteOutput(std::string const & path, std::span<glm::vec3 const> const samples)
+{
+    auto * file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return false;
+    }
+    for (auto const & sample : samples)
+    {
+        std::fprintf(file, "%.9g %.9g %.9g\n", sample.x, sample.y, sample.z);
+    }
+    std::fclose(file);
+    return true;
+}
+
+//-----------------------------------------------------
+
+int main(int const argc, char ** argv)
+{
+    Options options{};
+    if (ParseOptions(argc, argv, options) == false)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // The spans point either into the text input or into the mapped binary file
+    CurveInput input{};
+    std::shared_ptr<Cinpact::CurveFile> curveFile{};
+    std::span<glm::vec3 const> controlPoints{};
+    std::span<float const> cConstants{};
+    std::span<float const> kConstants{};
+
+    if (options.inputPath.ends_with(".cpb") == true)
+    {
+        curveFile = Cinpact::CurveFile::Load(options.inputPath);
+        if (curveFile == nullptr)
+        {
+            return 1;
+        }
+        input.interpolate = curveFile->Interpolate();
+        input.deltaU = curveFile->DeltaU();
+        controlPoints = curveFile->ControlPoints();
+        cConstants = curveFile->CConstants();
+        kConstants = curveFile->KConstants();
+    }
+    else
+    {
+        if (ReadInput(options.inputPath, input) == false)
+        {
+            return 1;
+        }
+        controlPoints = input.controlPoints;
+        cConstants = input.cConstants;
+        kConstants = input.kConstants;
+    }
+
+    if (options.binaryOutputPath.empty() == false)
+    {
+        std::vector<std::string> names{};
+        if (curveFile != nullptr)
+        {
+            names.reserve(controlPoints.size());
+            for (int i = 0; i < curveFile->PointCount(); ++i)
+            {
+                names.emplace_back(curveFile->Name(i));
+            }
+        }
+        Cinpact::CurveFileContent const content{
+            .interpolate = input.interpolate,
+            .deltaU = input.deltaU,
+            .controlPoints = controlPoints,
+            .cConstants = cConstants,
+            .kConstants = kConstants,
+            .names = names
+        };
+        if (Cinpact::SaveCurveFile(options.binaryOutputPath, content) == false)
+        {
+            return 1;
+        }
+    }
+
+    if (options.threadCount > 0)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(options.threadCount);
+#else
+        std::fprintf(stderr, "Built without OpenMP, --threads is ignored\n");
+#endif
+    }
+
+    std::vector<glm::vec3> samples(Cinpact::SampleCount(static_cast<int>(controlPoints.size()), input.deltaU));
+    int validCount = 0;
+
+    std::vector<double> durations(options.repetitions);
+    for (int i = 0; i < options.repetitions; ++i)
+    {
+        auto const startTime = std::chrono::steady_clock::now();
+        validCount = Cinpact::Generate(
+            input.interpolate,
+            controlPoints,
+            cConstants,
+            kConstants,
+            input.deltaU,
+            samples
+        );
+        durations[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    if (options.printTiming == true)
+    {
+        std::sort(durations.begin(), durations.end());
+        double totalDuration = 0.0;
+        for (auto const duration : durations)
+        {
+            totalDuration += duration;
+        }
+        auto const meanDuration = totalDuration / options.repetitions;
+        std::printf(
+            "control points %d, samples %d, valid %d, threads %d, simd %s\n"
+            "min %.3f ms, median %.3f ms, mean %.3f ms, max %.3f ms, %.3g samples/s\n",
+            static_cast<int>(controlPoints.size()),
+            static_cast<int>(samples.size()),
+            validCount,
+            MaxThreadCount(),
+            Cinpact::SimdInstructionSet(),
+            durations.front(),
+            durations[durations.size() / 2],
+            meanDuration,
+            durations.back(),
+            meanDuration > 0.0 ? samples.size() / (meanDuration * 1e-3) : 0.0
+        );
+    }
+
+    if (options.outputPath.empty() == false)
+    {
+        if (WriteOutput(options.outputPath, std::span<glm::vec3 const>{samples.data(), static_cast<size_t>(validCount)}) == false)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}